@@ -0,0 +1,33 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "types.h"
+#include <stdbool.h>
+
+// Fonts and audio are decoded on loader threads while the first frames are drawn. Each asset
+// has a handle that resolves once it has landed; until then its AppContext field stays NULL,
+// which every consumer already treats as "not available" (no text, no sound).
+typedef enum {
+    ASSET_FONT_LARGE, ASSET_FONT_REGULAR,
+    ASSET_SFX_PLACE_TILE, ASSET_SFX_VALID_WORD, ASSET_SFX_WARNING, ASSET_SFX_WIN,
+    ASSET_BGM_WELCOME,
+    ASSET_COUNT
+} AssetId;
+
+// Starts the loaders: one for fonts and one for the audio device and sounds, each working
+// through its assets in priority order. Timings are logged relative to app->launchedAt.
+void Assets_StartLoading(const AppContext *app);
+bool Assets_IsReady(AssetId id);
+// NULL until the asset has landed, and afterwards if it could not be loaded.
+void *Assets_Get(AssetId id);
+
+// Copy landed assets into app on the thread that uses them: fonts on the render thread (both
+// sizes at once, so FreeType is never used by two threads), sounds on the game thread.
+void Assets_ResolveFonts(AppContext *app);
+void Assets_ResolveAudio(AppContext *app);
+// Waits for the loaders and resolves everything into app, so cleanup sees every asset.
+void Assets_FinishLoading(AppContext *app);
+// Closes the fonts and frees the font file they were opened from.
+void Assets_Cleanup(AppContext *app);
+
+#endif
@@ -4,10 +4,32 @@
 #include "types.h"
 #include <stdbool.h>
 
-bool Audio_Init(AppContext *app);
+// Low-latency by default: a 512-sample buffer is about 12 ms at 44.1 kHz, against 46 ms for
+// the old 2048. WORDS_COLLIDE_AUDIO_BUFFER=256 (or 1024, 2048 on hardware that underruns)
+// overrides it; sizes are rounded down to a power of two within the limits below.
+#define AUDIO_DEFAULT_BUFFER_SAMPLES 512
+#define AUDIO_MIN_BUFFER_SAMPLES 128
+#define AUDIO_MAX_BUFFER_SAMPLES 4096
+#define AUDIO_MIXER_CHANNELS 8
+
+typedef struct {
+    int bufferSamples, frequency, channels;
+    int triggers;       // sounds started
+    int callbacks;      // mixer callbacks so far
+    int underruns;      // callbacks that came more than 1.5 buffers after the previous one
+    int lastLatencyUs;  // trigger to the first callback that mixed the sound, most recent
+} AudioStats;
+
+// Opens the mixer device; the sounds themselves are loaded by the asset loader (assets.h).
+bool Audio_Init(void);
+bool Audio_Open(int bufferSamples);
 void Audio_PlaySound(Mix_Chunk *sound);
 void Audio_PlayMusic(Mix_Music *music);
 void Audio_StopMusic(void);
+void Audio_GetStats(AudioStats *stats);
 void Audio_Cleanup(AppContext *app);
 
-#endif
\ No newline at end of file
+// --bench-audio: trigger-to-mix latency and underruns for each buffer size from 256 to 2048.
+int Audio_RunBenchmark(void);
+
+#endif
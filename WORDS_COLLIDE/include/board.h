@@ -0,0 +1,44 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include "types.h"
+#include <stdalign.h>
+
+#define BOARD_OCCUPANCY_WORDS ((GRID_COLS * GRID_ROWS + 63) / 64)
+
+// The part of a match the rules look at, for code that tries many moves (replay seeking,
+// move search) without dragging a multi-kilobyte GameState along. Counters and occupancy
+// share the first cache line; the whole struct is four lines.
+typedef struct {
+    alignas(64) Sint32 scores[2];
+    Uint16 filled;
+    Uint16 scoredWordCount; // handle into the owner's scored-word list; entries past it are stale
+    Uint8 sideToMove;
+    Uint64 occupancy[BOARD_OCCUPANCY_WORDS]; // bit x * GRID_ROWS + y for each placed tile
+    char grid[GRID_COLS][GRID_ROWS];
+} BoardState;
+
+// Everything Board_UnmakeMove needs to put the board back exactly.
+typedef struct {
+    Uint8 x, y, mover;
+    Sint16 scoreDelta;
+    Uint16 scoredWordCount;
+} BoardUndo;
+
+void Board_FromGame(BoardState *board, const GameState *game);
+void Board_ToGame(const BoardState *board, GameState *game);
+// Rebuilds occupancy and the fill count after grid has been written directly.
+void Board_SyncOccupancy(BoardState *board);
+bool Board_IsOccupied(const BoardState *board, int x, int y);
+
+// Places letter for the side to move, scores it by the rules (the mover gains the score if it
+// is positive) and passes the turn. Returns the rules' score, as Logic_CheckAndScore does.
+int Board_MakeMove(BoardState *board, int x, int y, char letter, BoardUndo *undo);
+// The same, with the score decided elsewhere (bot moves, server-validated moves).
+void Board_MakeScoredMove(BoardState *board, int x, int y, char letter, int scoreDelta, BoardUndo *undo);
+void Board_UnmakeMove(BoardState *board, const BoardUndo *undo);
+
+// --bench-board: make/unmake pairs per second, against copying a GameState per move.
+void Board_RunBenchmark(void);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "types.h"
+#include <stdbool.h>
+
+// Paces the render thread on either vsync or a precise sleep (never both), and lets the game
+// thread block on its event queue until the next simulation tick, or longer while nothing on
+// screen needs to move.
+void Frame_Init(AppContext *app);
+// Game thread. Returns the first event the render thread has forwarded, but may wait for one.
+bool Frame_WaitForEvent(const GameState *game, SDL_Event *event);
+bool Frame_IsWindowVisible(void);
+// True while nothing on screen moves (a paused match or a minimised window), so the render
+// thread only needs to draw when a new snapshot arrives.
+bool Frame_IsIdle(const GameState *game);
+// Render thread: brackets one frame. Finish presents if something was drawn, then sleeps out
+// the rest of the frame when not on vsync.
+void Frame_Begin(void);
+void Frame_Finish(AppContext *app, GameStateEnum screen, bool didRender);
+void Frame_Report(void);
+
+#endif
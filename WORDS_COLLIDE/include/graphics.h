@@ -3,20 +3,34 @@
 
 #include "types.h"
 
-void Graphics_RenderSplashScreen(AppContext *app, GameState *game);
-void Graphics_RenderModeMenu(AppContext *app, GameState *game);
-void Graphics_RenderOpponentMenu(AppContext *app, GameState *game);
-void Graphics_RenderBotMenu(AppContext *app, GameState *game);
-void Graphics_RenderMultiplayerMenu(AppContext *app, GameState *game);
-void Graphics_RenderIPInput(AppContext *app, GameState *game);
-void Graphics_RenderNameInput(AppContext *app, GameState *game);
-void Graphics_RenderTutorial(AppContext *app, GameState *game);
-void Graphics_RenderGame(AppContext *app, GameState *game);
-void Graphics_RenderGameOver(AppContext *app, GameState *game);
-void Graphics_RenderWaitingForOpponent(AppContext *app, GameState *game);
+void Graphics_RenderSplashScreen(AppContext *app, const GameState *game);
+void Graphics_RenderModeMenu(AppContext *app, const GameState *game);
+void Graphics_RenderOpponentMenu(AppContext *app, const GameState *game);
+void Graphics_RenderBotMenu(AppContext *app, const GameState *game);
+void Graphics_RenderMultiplayerMenu(AppContext *app, const GameState *game);
+void Graphics_RenderIPInput(AppContext *app, const GameState *game);
+void Graphics_RenderNameInput(AppContext *app, const GameState *game);
+void Graphics_RenderTutorial(AppContext *app, const GameState *game);
+void Graphics_RenderGame(AppContext *app, const GameState *game);
+void Graphics_RenderGameOver(AppContext *app, const GameState *game);
+void Graphics_RenderWaitingForOpponent(AppContext *app, const GameState *game);
 
-void Graphics_RenderMysteryTutorial(AppContext *app, GameState *game);
-void Graphics_RenderMystery(AppContext *app, GameState *game);
-void Graphics_RenderMysteryGameOver(AppContext *app, GameState *game);
+void Graphics_RenderMysteryTutorial(AppContext *app, const GameState *game);
+void Graphics_RenderMystery(AppContext *app, const GameState *game);
+void Graphics_RenderMysteryGameOver(AppContext *app, const GameState *game);
+// Renders whichever of the screens above belongs to game->currentState.
+void Graphics_RenderScreen(AppContext *app, const GameState *game);
+
+typedef struct { int drawCalls, textureUploads, textDraws; } GraphicsFrameStats;
+
+// Frame bookkeeping for the texture upload report printed by Graphics_Cleanup.
+void Graphics_EndFrame(void);
+// Counts for the frame most recently closed by Graphics_EndFrame.
+void Graphics_GetFrameStats(GraphicsFrameStats *stats);
+// Freezes the clock animations read at ticks (for repeatable frames); false follows SDL_GetTicks.
+void Graphics_PinClock(bool isPinned, Uint32 ticks);
+void Graphics_Cleanup(void);
+// Drops the cached button and board layers; call when SDL reports SDL_RENDER_TARGETS_RESET.
+void Graphics_ResetRenderTargets(void);
 
 #endif
\ No newline at end of file
@@ -3,6 +3,10 @@
 
 #include "types.h"
 
+// Game thread: asks for SDL text input on or off. Render thread: applies the latest request.
+void Input_SetTextInput(bool isActive);
+void Input_ApplyTextInput(void);
+
 void Input_HandleSplash(SDL_Event *event, GameState *game);
 void Input_HandleModeMenu(SDL_Event *event, GameState *game);
 void Input_HandleOpponentMenu(SDL_Event *event, GameState *game);
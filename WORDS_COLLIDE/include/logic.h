@@ -2,6 +2,7 @@
 #define LOGIC_H
 
 #include "types.h"
+#include "network.h"
 
 #define MAX_WORDS_IN_DICT 200000
 #define MAX_BONUS_WORDS 6
@@ -16,6 +17,10 @@ void Logic_CheckWinConditions(GameState *game, AppContext *app);
 
 // New UI and Network additions
 void Logic_InitGameState(GameState *game);
-void Logic_HandleNetworkMessage(GameState *game, AppContext *app, char *msg);
+void Logic_LayoutScreen(GameState *game);
+void Logic_HandleNetworkMessage(GameState *game, AppContext *app, const GameMessage *msg);
+void Logic_OnMatchStarted(GameState *game);
+void Logic_RecordMatchEvent(GameState *game, const GameMessage *msg);
+void Logic_UpdateConnection(GameState *game);
 
 #endif
\ No newline at end of file
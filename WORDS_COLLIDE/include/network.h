@@ -3,16 +3,77 @@
 
 #include <stdbool.h>
 #include <SDL2/SDL_net.h>
+#include "protocol.h"
+
+#define NET_MAX_MESSAGES_PER_FRAME 64
+
+// A decoded message handed between the network thread and the game loop.
+typedef struct {
+    GameMessage message;
+    Uint64 receivedAt;
+} NetMessage;
+
+typedef struct {
+    int inboundDepth, inboundMaxDepth;
+    int outboundDepth, outboundMaxDepth;
+    int outboundDropped;
+    int messagesSent, sendBatches;
+    double sendStallMs;    // network thread blocked inside SDLNet_TCP_Send
+    double inboundStallMs; // network thread waiting on a full inbound queue
+    double rttMs, jitterMs;
+    int clockOffsetMs;     // shared (host) clock minus ours
+    bool isClockSynced;
+    bool isUdp;
+    int reliableResends;   // UDP only: reliable messages sent again after a loss
+    int simulatedDisconnects, simulatedReorders, simulatedLosses; // from the impairment shim
+} NetworkStats;
+
+// Hosts accept both; the joiner picks one before calling Network_JoinGame.
+typedef enum { NET_TRANSPORT_TCP, NET_TRANSPORT_UDP } NetTransport;
+
+// Simulated network conditions, applied to everything this peer receives. Testing only:
+// set it before hosting or joining, or through WORDS_COLLIDE_NETSIM, e.g.
+// "latency=60,jitter=20,kbps=64,reorder=5,loss=2,drop-every=8000,drop-for=1500".
+typedef struct {
+    int latencyMs, jitterMs;  // one-way delay is latency +/- jitter
+    int bandwidthKbps;        // 0 = unlimited
+    int reorderPercent;       // chance a message is held back behind later ones
+    int lossPercent;          // UDP only; TCP would just retransmit
+    int disconnectEveryMs;    // 0 = never
+    int disconnectForMs;      // no reconnecting (or accepting) until this has passed
+    unsigned seed;
+} NetImpairment;
 
 bool Network_Init(void);
+void Network_SetImpairment(const NetImpairment *impairment);
+void Network_SetTransport(NetTransport transport);
 bool Network_HostGame(int port);
 bool Network_JoinGame(const char* ipAddress, int port);
-bool Network_SendMessage(const char* msg);
-int Network_ReceiveMessage(char* buffer, int maxLen);
+bool Network_SendMessage(const GameMessage *message);
+bool Network_IsConnected(void);
+int Network_GetLinkGeneration(void);
+Uint32 Network_LocalToSharedTicks(Uint32 localTicks);
+Uint32 Network_SharedToLocalTicks(Uint32 sharedTicks);
+bool Network_IsClockSynced(void);
+int Network_ReceiveMessages(NetMessage *messages, int maxMessages);
+void Network_MarkApplied(const NetMessage *message);
+void Network_GetStats(NetworkStats *stats);
+bool Network_PublishSpectatorUpdate(const GameMessage *message);
 void Network_Cleanup(void);
 
+// LAN discovery. The host list is kept by a background thread; labels arrive pre-formatted.
+#define NET_MAX_DISCOVERED_HOSTS 8
+typedef struct {
+    char ip[16];
+    int port;
+    bool isInMatch; // joining would make us a spectator
+    char label[64];
+} DiscoveredHost;
+
 const char* Network_GetLocalIP();
-void Network_BroadcastPresence(const char* hostName);
-bool Network_ListenForHost(char* foundIP);
+void Network_SetHostInfo(const char *hostName, bool isInMatch);
+void Network_StartBrowsing(void);
+void Network_StopBrowsing(void);
+int Network_GetDiscoveredHosts(DiscoveredHost *hosts, int maxHosts);
 
 #endif
\ No newline at end of file
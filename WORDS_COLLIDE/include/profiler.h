@@ -0,0 +1,75 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "types.h"
+#include <stdbool.h>
+
+// Per-phase frame timings and per-frame counters for the F2 performance overlay. Everything
+// goes through the PROFILE_* macros below, which compile to nothing when NDEBUG is defined,
+// so release builds carry no timing calls, counters or overlay.
+#ifndef NDEBUG
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+#define PROFILE_HISTORY 120
+
+typedef enum {
+    PROFILE_SIMULATION,
+    PROFILE_EVENTS,
+    PROFILE_NETWORK,
+    PROFILE_RENDER,
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+typedef enum {
+    PROFILE_TEXTURE_CREATES,
+    PROFILE_TTF_RENDERS,
+    PROFILE_DICTIONARY_LOOKUPS,
+    PROFILE_NET_MESSAGES,
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+typedef struct {
+    float frameMs[PROFILE_HISTORY];         // ring buffer, oldest first from index `newest + 1`
+    int newest;
+    float phaseMs[PROFILE_PHASE_COUNT];     // last finished frame
+    int counters[PROFILE_COUNTER_COUNT];    // last finished frame
+} ProfileSnapshot;
+
+#if PROFILER_ENABLED
+
+void Profiler_BeginPhase(ProfilePhase phase);
+void Profiler_EndPhase(ProfilePhase phase);
+void Profiler_Add(ProfileCounter counter, int amount);
+// Closes the frame: records its length and moves the phase times and counters to the snapshot.
+void Profiler_EndFrame(void);
+void Profiler_ToggleOverlay(void);
+bool Profiler_IsOverlayVisible(void);
+const ProfileSnapshot *Profiler_GetSnapshot(void);
+// Implemented in graphics.c, which owns the text and geometry helpers.
+void Graphics_RenderProfilerOverlay(AppContext *app);
+
+#define PROFILE_BEGIN(phase) Profiler_BeginPhase(phase)
+#define PROFILE_END(phase) Profiler_EndPhase(phase)
+#define PROFILE_COUNT(counter) Profiler_Add(counter, 1)
+#define PROFILE_ADD(counter, amount) Profiler_Add(counter, amount)
+#define PROFILE_END_FRAME() Profiler_EndFrame()
+#define PROFILE_TOGGLE_OVERLAY() Profiler_ToggleOverlay()
+#define PROFILE_DRAW_OVERLAY(app) \
+    do { if (Profiler_IsOverlayVisible()) Graphics_RenderProfilerOverlay(app); } while (0)
+
+#else
+
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_COUNT(counter) ((void)0)
+#define PROFILE_ADD(counter, amount) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+#define PROFILE_TOGGLE_OVERLAY() ((void)0)
+#define PROFILE_DRAW_OVERLAY(app) ((void)0)
+
+#endif
+
+#endif
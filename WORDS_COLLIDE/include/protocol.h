@@ -0,0 +1,80 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "rules.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Version 1 is the original newline-terminated ASCII protocol.
+// Version 2 frames are [u16 body length, big endian][u8 type][fixed payload].
+#define PROTOCOL_VERSION 2
+#define PROTOCOL_MAX_FRAME 320
+
+// ASSIGN and STATE are only sent by the dedicated server (see server/server.c).
+// SNAPSHOT opens a spectator stream, which then continues as STATE/PAUSE/GIVE_UP deltas.
+// RESUME/RESYNC reattach a player after a dropped connection (see Logic_OnResume).
+// PING/PONG are binary-only and never reach the game loop; the network thread handles them.
+typedef enum {
+    MSG_READY, MSG_READY_ACK, MSG_MOVE, MSG_PAUSE_ON, MSG_PAUSE_OFF, MSG_GIVE_UP,
+    MSG_ASSIGN, MSG_STATE, MSG_SNAPSHOT, MSG_RESUME, MSG_RESYNC, MSG_PING, MSG_PONG,
+    MSG_COUNT
+} GameMessageType;
+
+// Payloads are byte-only so their in-memory layout is the wire layout.
+typedef struct { uint8_t playerId; char name[MAX_NAME_LENGTH]; } ReadyPayload;
+// turnStartMs is when the next turn began, in the shared (host) timebase; 0 if unknown.
+typedef struct { uint8_t x, y; char letter; uint8_t turnStartMs[4]; } MovePayload;
+typedef struct { uint8_t playerId; } GiveUpPayload;
+typedef struct { uint8_t seat; } AssignPayload;
+// Authoritative result of a validated move. Scores are big endian; turnStartMs is as in MovePayload.
+typedef struct { uint8_t x, y; char letter; uint8_t nextPlayer; uint8_t scores[2][2]; uint8_t turnStartMs[4]; } StatePayload;
+// Everything a late joiner needs to draw the match. On the wire the grid is sent as an
+// occupancy bitmap followed by only the placed letters, so an early board costs ~80 bytes.
+typedef struct {
+    uint8_t scores[2][2];
+    uint8_t currentPlayer, gameMode, isPaused;
+    uint8_t gameElapsedMs[4], turnElapsedMs[4];
+    uint8_t seq[4]; // sequence number of the last event already in the snapshot
+    char names[2][MAX_NAME_LENGTH];
+    char grid[GRID_COLS][GRID_ROWS];
+} SnapshotPayload;
+// Sequence numbers count match events (placements, pauses, resignations) from 1.
+typedef struct { uint8_t lastSeq[4]; } ResumePayload;
+// The next count messages bring the receiver from baseSeq up to date.
+typedef struct { uint8_t baseSeq[4]; uint8_t count[2]; } ResyncPayload;
+// NTP-style exchange in microseconds: t0 ping sent, t1 ping received, t2 pong sent.
+typedef struct { uint8_t t0[8]; } PingPayload;
+typedef struct { uint8_t t0[8], t1[8], t2[8]; } PongPayload;
+
+typedef struct {
+    GameMessageType type;
+    union {
+        ReadyPayload ready;
+        MovePayload move;
+        GiveUpPayload giveUp;
+        AssignPayload assign;
+        StatePayload state;
+        SnapshotPayload snapshot;
+        ResumePayload resume;
+        ResyncPayload resync;
+        PingPayload ping;
+        PongPayload pong;
+    };
+} GameMessage;
+
+int Protocol_EncodeBinary(const GameMessage *message, uint8_t *out);
+int Protocol_BinarySize(const GameMessage *message);
+bool Protocol_DecodeBinary(const uint8_t *body, int length, GameMessage *message);
+int Protocol_EncodeText(const GameMessage *message, char *out, int maxLen);
+bool Protocol_DecodeText(const char *line, GameMessage *message);
+
+StatePayload Protocol_MakeState(int x, int y, char letter, int nextPlayer, const int scores[2], uint32_t turnStartMs);
+int Protocol_StateScore(const StatePayload *state, int player);
+void Protocol_PutU32(uint8_t out[4], uint32_t value);
+uint32_t Protocol_GetU32(const uint8_t in[4]);
+void Protocol_PutU64(uint8_t out[8], uint64_t value);
+uint64_t Protocol_GetU64(const uint8_t in[8]);
+
+void Protocol_RunBenchmark(void);
+
+#endif
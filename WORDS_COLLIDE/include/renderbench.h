@@ -0,0 +1,10 @@
+#ifndef RENDERBENCH_H
+#define RENDERBENCH_H
+
+// Renders every screen from a fixed GameState with the software renderer into an offscreen
+// surface (no window, dummy video driver) and reports frame times and draw calls.
+// dumpDir, if set, receives one BMP per screen; compareDir, if set, is checked against them.
+// Returns the process exit code: non-zero if setup failed or a screen differs from its golden image.
+int RenderBench_Run(int frames, const char *dumpDir, const char *compareDir);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include "types.h"
+#include <stdbool.h>
+
+// The render thread is the main thread: it created the window, so it also owns the renderer,
+// everything in graphics.c and the SDL event pump. The game loop (input handling, the
+// simulation and the network) runs on a worker thread. Events go to it through a queue, and it
+// hands back read-only copies of GameState through a triple buffer, so a slow frame never holds
+// up input or the network and a slow tick never holds up presenting.
+
+// Creates the renderer; call it on the thread that created the window. game is the first
+// snapshot drawn.
+bool RenderThread_Start(AppContext *app, const GameState *game);
+// Starts gameMain(data) on the game thread and draws until it returns. Returns its result.
+int RenderThread_Run(SDL_ThreadFunction gameMain, void *data);
+// Game thread. Takes the next forwarded event, waiting up to timeoutMs for one.
+bool RenderThread_NextEvent(SDL_Event *event, Uint32 timeoutMs);
+// Game thread. Copies game for the render thread; it draws the newest snapshot at its next frame.
+void RenderThread_Publish(const GameState *game);
+// Frees the renderer and prints the snapshot handoff latency.
+void RenderThread_Stop(void);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "board.h"
+#include <stdbool.h>
+
+// Every Words Collide match is recorded as a bit-packed move log: (x, y, letter, player,
+// time since the previous move, score if the rules would not give it), with a keyframe of the
+// board, scores and side to move after every REPLAY_KEYFRAME_INTERVAL moves. Seeking to a turn
+// decodes the keyframe at or before it and at most REPLAY_KEYFRAME_INTERVAL - 1 moves.
+#define REPLAY_KEYFRAME_INTERVAL 16
+#define REPLAY_TIME_UNIT_MS 50
+#define REPLAY_MAX_BYTES 4096
+#define REPLAY_MAX_KEYFRAMES (GRID_COLS * GRID_ROWS / REPLAY_KEYFRAME_INTERVAL + 1)
+#define REPLAY_PATH "last_match.wcr"
+
+#define REPLAY_FLAG_MULTIPLAYER 0x01
+#define REPLAY_FLAG_BOT 0x02
+#define REPLAY_FLAG_SERVER 0x04
+#define REPLAY_FLAG_SPECTATOR 0x08
+
+typedef struct {
+    Uint8 gameMode, flags;
+    char playerNames[2][MAX_NAME_LENGTH];
+    int moveCount, keyframeCount;
+    Uint16 keyframeAt[REPLAY_MAX_KEYFRAMES]; // bit offset of each keyframe in stream
+    Uint32 streamBits;
+    Uint8 stream[REPLAY_MAX_BYTES];
+} Replay;
+
+// Recording, on the game thread. Begin keyframes the board as it stands (empty at the start of
+// a match, or whatever a snapshot just restored). Moves are recorded after game reflects them.
+void Replay_Begin(const GameState *game);
+void Replay_RecordMove(const GameState *game, int x, int y, char letter, int player, int scoreDelta, int rulesScore);
+// Writes the recording to REPLAY_PATH in one write and stops recording; no-op if not recording.
+void Replay_Finish(void);
+
+bool Replay_Load(const char *path, Replay *replay);
+// Restores the board after `turn` moves, making the moves since the nearest keyframe with
+// Board_MakeMove. Returns match time at that turn (ms).
+Uint32 Replay_Seek(const Replay *replay, int turn, BoardState *board);
+// --replay: prints the board at a turn (default: the end) and how long seeking takes.
+int Replay_Run(const char *path, int turn);
+
+#endif
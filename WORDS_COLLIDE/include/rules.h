@@ -0,0 +1,26 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <stdbool.h>
+
+// Match rules shared by the game and the headless server. Must not depend on SDL.
+#define NETWORK_PORT 9021
+#define WIN_SCORE 400
+#define MERCY_LEAD 70
+#define MAX_BOARD_FILL 0.85
+
+// THE RECTANGULAR GRID
+#define GRID_COLS 20
+#define GRID_ROWS 10
+
+#define MAX_NAME_LENGTH 16
+#define PLACEMENT_SCORE 10
+
+typedef enum { END_NONE, END_SCORE_LIMIT, END_MERCY_LEAD, END_BOARD_FULL } MatchEndReason;
+
+bool Rules_IsLegalMove(const char grid[GRID_COLS][GRID_ROWS], int x, int y, char letter);
+int Rules_ScorePlacement(const char grid[GRID_COLS][GRID_ROWS], int x, int y, char letter);
+MatchEndReason Rules_CheckEnd(const char grid[GRID_COLS][GRID_ROWS], const int scores[2]);
+const char *Rules_EndReasonText(MatchEndReason reason);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef SAVE_H
+#define SAVE_H
+
+#include "types.h"
+#include <stdbool.h>
+
+// Suspend/resume for local Words Collide matches (vs bot or co-op on one machine). Networked
+// matches are not saved: the peer or server owns half of that state.
+#define SAVE_VERSION 1
+#define SAVE_PATH "savegame.wcs"
+
+// Everything needed to carry on a match, and nothing else: no pointers, no button rects, no
+// selection or hover state, no highlight flashes. Times are stored as elapsed milliseconds
+// and rebased onto the simulation clock on load. Fields are fixed-width and the record is
+// zeroed before it is filled; it is written and read as a whole, in the machine's byte order.
+typedef struct {
+    char magic[3];
+    Uint8 version;
+    Uint32 size;     // sizeof(SaveGame), so a build with a different layout rejects the file
+    Uint32 checksum; // FNV-1a of the whole record with this field zeroed
+
+    Uint8 isSinglePlayer, botDifficulty, gameMode, currentPlayer;
+    char playerNames[2][MAX_NAME_LENGTH];
+    char grid[GRID_COLS][GRID_ROWS];
+    Sint32 scores[2];
+    Sint32 scoredWordCount;
+    char scoredWords[MAX_SCORED_WORDS][MAX_WORD_LENGTH];
+
+    Uint32 gameElapsedMs, turnElapsedMs;
+
+    char longestWord[MAX_WORD_LENGTH];
+    char bestWord[MAX_WORD_LENGTH];
+    Sint32 longestWordLen, bestWordScore;
+    Uint32 totalTurnTime[2];
+    Sint32 turnsPlayed[2];
+    Sint32 bonusWordsCount[2];
+} SaveGame;
+
+bool Save_IsSaveable(const GameState *game);
+// Writes SAVE_PATH with a single fwrite (to a temporary file that then replaces it).
+bool Save_Write(const GameState *game);
+// Saves after every move of a saveable match; called once per simulation tick.
+void Save_Autosave(const GameState *game);
+// Validates SAVE_PATH and restores it into game, which should be freshly initialised and have
+// its simulation clock running. The match resumes paused, with its timers picking up where
+// they stopped once the clocks are synced.
+bool Save_Load(GameState *game);
+// Deletes the save once its match is over; no-op if this run has not saved or resumed.
+void Save_Discard(void);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "types.h"
+
+// Game rules that depend on time run here, on a fixed tick driven by the high-resolution
+// counter, so they behave the same at any frame rate. game->simTime is the time of the latest
+// tick on SDL_GetTicks' epoch (network timestamps convert to and from it unchanged); input and
+// logic stamp events with it instead of reading the clock themselves.
+#define SIM_TICK_MS 10
+#define SIM_MAX_CATCH_UP_TICKS 50 // after a longer stall the clock jumps instead of replaying
+#define SIM_BOT_THINK_MS 1500
+
+void Simulation_Init(GameState *game);
+// Runs every tick that has come due since the last call. game->simTickAt records when the
+// latest one fell due, so the renderer can tell how far it is towards the next.
+void Simulation_Advance(GameState *game, AppContext *app);
+// Recomputes the timers derived from game->simTime with nothing to interpolate from (after
+// setting the clock or the match times by hand).
+void Simulation_SyncClocks(GameState *game);
+// Milliseconds until the next tick falls due (0 if it already has).
+int Simulation_MsUntilNextTick(const GameState *game);
+
+#endif
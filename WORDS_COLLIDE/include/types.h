@@ -6,21 +6,18 @@
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_net.h>
-
-// --- THE NEW JAVA MATH RULES ---
-#define NETWORK_PORT 9021
-#define WIN_SCORE 400
-#define MERCY_LEAD 70
-#define MAX_BOARD_FILL 0.85
+#include "rules.h"
 
 #define WINDOW_WIDTH 1280
 #define WINDOW_HEIGHT 720
 
-// THE RECTANGULAR GRID
-#define GRID_COLS 20
-#define GRID_ROWS 10
 #define TILE_SIZE 50
 
+// Discovered LAN hosts on the join screen
+#define HOST_LIST_Y 330
+#define HOST_LIST_ROW_HEIGHT 40
+#define HOST_LIST_ROWS 4
+
 #define MYSTERY_ROWS 6
 #define MYSTERY_COLS 5
 
@@ -32,7 +29,6 @@
 #define MAX_WORD_LENGTH 25
 #define MAX_SCORED_WORDS 100
 #define BONUS_WORD_POINTS 50
-#define MAX_NAME_LENGTH 16
 
 typedef enum {
     STATE_SPLASH, STATE_MODE_MENU, STATE_OPPONENT_MENU, STATE_BOT_MENU, STATE_MULTIPLAYER_MENU,
@@ -53,6 +49,7 @@ typedef struct {
     Mix_Chunk *sfxWarning;
     Mix_Chunk *sfxWin;
     Mix_Music *bgmWelcome;
+    Uint64 launchedAt; // performance counter at startup, for load and first-frame timings
 } AppContext;
 
 typedef struct {
@@ -64,6 +61,10 @@ typedef struct {
     int botDifficulty;
     bool isMultiplayer;
     int localPlayerId;
+    bool isServerMatch;
+    bool isSpectator;
+    bool isReconnecting;
+    bool isNetOverlayVisible;
     bool playerReady[2];
 
     char grid[GRID_COLS][GRID_ROWS];
@@ -83,6 +84,12 @@ typedef struct {
     Uint32 botThinkStartTime;
     Uint32 tutorialStartTime;
     Uint32 lastFrameTime;
+    // Fixed-timestep clock (see simulation.h) and the timers each tick derives from it, with
+    // the previous tick's values for the renderer to interpolate between.
+    Uint32 simTime;
+    Uint64 simTickAt; // performance counter when the latest tick fell due
+    Uint32 gameTimeLeft, prevGameTimeLeft;
+    Uint32 turnTimeLeft, prevTurnTimeLeft;
 
     bool isPaused;
     int gameMode;
@@ -104,8 +111,9 @@ typedef struct {
     int mysteryRow;
     int mysteryCol;
     int mysteryState;
+    bool isMysteryAdversarial;
 
-    Button playWordsCollideButton, playMysteryButton, classicModeButton, blitzModeButton;
+    Button playWordsCollideButton, playMysteryButton, playMysteryHardButton, classicModeButton, blitzModeButton;
     Button singlePlayerButton, startGameButton, multiplayerButton, botEasyButton, botHardButton;
     Button hostGameButton, joinGameButton, backButton, giveUpButton, pauseButton, playAgainButton;
 } GameState;
@@ -0,0 +1,269 @@
+// Local load generator for the headless server (Linux only).
+//
+//   gcc -O2 server/loadgen.c src/rules.c src/protocol.c -o wc_loadgen
+//   ./wc_loadgen [--host 127.0.0.1] [--port 9021] [--games 10000] [--seconds 60] [--move-ms 1000]
+//
+// Every simulated player speaks the same protocol as the game client: HELLO handshake,
+// READY, then a MOVE on each of its turns, paced like a (fast) human. Finished games
+// reconnect so the number of concurrent matches stays at --games.
+#define _GNU_SOURCE
+#include "../include/rules.h"
+#include "../include/protocol.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOADGEN_RECV_BUFFER 1024
+#define LOADGEN_CONNECTS_PER_TICK 200
+#define LOADGEN_LATENCY_BUCKETS 10000 // 0.1 ms each, up to 1 s
+
+typedef struct {
+    int fd;
+    bool isConnecting;
+    bool sendBinary;
+    bool recvBinary;
+    int seat;
+    bool isOpponentReady;
+    bool isOver;
+    int currentPlayer;
+    long long nextMoveAt;
+    long long moveSentAt; // 0 when no move is in flight
+    char grid[GRID_COLS][GRID_ROWS];
+    int recvLen;
+    char recvBuf[LOADGEN_RECV_BUFFER];
+} Player;
+
+static struct sockaddr_in s_server;
+static int s_epollFd;
+static int s_moveIntervalMs = 1000;
+static long s_latencyHistogram[LOADGEN_LATENCY_BUCKETS + 1];
+static long s_moves = 0, s_gamesFinished = 0, s_failures = 0;
+
+static long long Loadgen_NowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void Loadgen_SendRaw(Player *player, const void *data, int len) {
+    if (player->fd < 0) return;
+    if (send(player->fd, data, len, MSG_NOSIGNAL) != len) s_failures++;
+}
+
+static void Loadgen_Send(Player *player, const GameMessage *message) {
+    char frame[PROTOCOL_MAX_FRAME];
+    int len = player->sendBinary ? Protocol_EncodeBinary(message, (uint8_t *)frame)
+                                 : Protocol_EncodeText(message, frame, sizeof(frame));
+    Loadgen_SendRaw(player, frame, len);
+}
+
+static void Loadgen_Connect(Player *player) {
+    memset(player, 0, sizeof(*player));
+    player->seat = -1;
+    player->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (player->fd < 0) { s_failures++; return; }
+    int yes = 1;
+    setsockopt(player->fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    if (connect(player->fd, (struct sockaddr *)&s_server, sizeof(s_server)) < 0 && errno != EINPROGRESS) {
+        close(player->fd);
+        player->fd = -1;
+        s_failures++;
+        return;
+    }
+    player->isConnecting = true;
+    struct epoll_event ev = {.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP, .data.ptr = player};
+    epoll_ctl(s_epollFd, EPOLL_CTL_ADD, player->fd, &ev);
+}
+
+static void Loadgen_Disconnect(Player *player) {
+    if (player->fd < 0) return;
+    epoll_ctl(s_epollFd, EPOLL_CTL_DEL, player->fd, NULL);
+    close(player->fd);
+    player->fd = -1;
+}
+
+static void Loadgen_OnConnected(Player *player) {
+    player->isConnecting = false;
+    struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP, .data.ptr = player};
+    epoll_ctl(s_epollFd, EPOLL_CTL_MOD, player->fd, &ev);
+    char hello[32];
+    Loadgen_SendRaw(player, hello, sprintf(hello, "HELLO,%d\n", PROTOCOL_VERSION));
+    GameMessage ready = {.type = MSG_READY, .ready = {0, "loadgen"}};
+    Loadgen_Send(player, &ready);
+}
+
+static void Loadgen_HandleMessage(Player *player, const GameMessage *message) {
+    switch (message->type) {
+        case MSG_ASSIGN:
+            player->seat = message->assign.seat;
+            break;
+        case MSG_READY:
+            player->isOpponentReady = true;
+            Loadgen_Send(player, &(GameMessage){.type = MSG_READY_ACK, .ready = {0, "loadgen"}});
+            break;
+        case MSG_READY_ACK:
+            player->isOpponentReady = true;
+            break;
+        case MSG_STATE: {
+            const StatePayload *state = &message->state;
+            player->grid[state->x][state->y] = state->letter;
+            if (player->moveSentAt && state->nextPlayer != player->seat) {
+                long long bucket = (Loadgen_NowUs() - player->moveSentAt) / 100;
+                s_latencyHistogram[bucket < LOADGEN_LATENCY_BUCKETS ? bucket : LOADGEN_LATENCY_BUCKETS]++;
+                player->moveSentAt = 0;
+                s_moves++;
+            }
+            player->currentPlayer = state->nextPlayer;
+            player->nextMoveAt = Loadgen_NowUs() / 1000 + s_moveIntervalMs;
+            int scores[2] = {Protocol_StateScore(state, 0), Protocol_StateScore(state, 1)};
+            if (Rules_CheckEnd(player->grid, scores) != END_NONE) player->isOver = true;
+            break;
+        }
+        case MSG_GIVE_UP:
+            player->isOver = true;
+            break;
+        default:
+            break;
+    }
+}
+
+static void Loadgen_Read(Player *player) {
+    for (;;) {
+        ssize_t n = recv(player->fd, player->recvBuf + player->recvLen, LOADGEN_RECV_BUFFER - player->recvLen, 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            if (!player->isOver) s_failures++;
+            Loadgen_Disconnect(player);
+            return;
+        }
+        if (n < 0) return;
+        player->recvLen += (int)n;
+
+        int pos = 0;
+        while (pos < player->recvLen) {
+            GameMessage message;
+            if (player->recvBinary) {
+                if (player->recvLen - pos < 2) break;
+                int bodyLen = ((uint8_t)player->recvBuf[pos] << 8) | (uint8_t)player->recvBuf[pos + 1];
+                if (player->recvLen - pos < 2 + bodyLen) break;
+                if (Protocol_DecodeBinary((const uint8_t *)player->recvBuf + pos + 2, bodyLen, &message))
+                    Loadgen_HandleMessage(player, &message);
+                pos += 2 + bodyLen;
+            } else {
+                char *newline = memchr(player->recvBuf + pos, '\n', player->recvLen - pos);
+                if (!newline) break;
+                *newline = '\0';
+                const char *line = player->recvBuf + pos;
+                pos = (int)(newline - player->recvBuf) + 1;
+                int version;
+                if (sscanf(line, "HELLO,%d", &version) == 1) {
+                    Loadgen_SendRaw(player, "HELLO_ACK\n", 10);
+                    player->sendBinary = true;
+                } else if (strcmp(line, "HELLO_ACK") == 0) {
+                    player->recvBinary = true;
+                } else if (Protocol_DecodeText(line, &message)) {
+                    Loadgen_HandleMessage(player, &message);
+                }
+            }
+        }
+        player->recvLen -= pos;
+        memmove(player->recvBuf, player->recvBuf + pos, player->recvLen);
+    }
+}
+
+static void Loadgen_MaybeMove(Player *player, long long nowMs) {
+    if (player->fd < 0 || player->seat < 0 || !player->isOpponentReady || player->isOver) return;
+    if (player->currentPlayer != player->seat || player->moveSentAt || nowMs < player->nextMoveAt) return;
+    int start = rand() % (GRID_COLS * GRID_ROWS);
+    for (int i = 0; i < GRID_COLS * GRID_ROWS; i++) {
+        int cell = (start + i) % (GRID_COLS * GRID_ROWS);
+        int x = cell % GRID_COLS, y = cell / GRID_COLS;
+        if (player->grid[x][y]) continue;
+        GameMessage move = {.type = MSG_MOVE, .move = {.x = (uint8_t)x, .y = (uint8_t)y, .letter = (char)('A' + rand() % 26)}};
+        player->moveSentAt = Loadgen_NowUs();
+        Loadgen_Send(player, &move);
+        return;
+    }
+}
+
+static double Loadgen_Percentile(double fraction) {
+    long total = 0, seen = 0;
+    for (int i = 0; i <= LOADGEN_LATENCY_BUCKETS; i++) total += s_latencyHistogram[i];
+    for (int i = 0; i <= LOADGEN_LATENCY_BUCKETS; i++) {
+        seen += s_latencyHistogram[i];
+        if (total && seen >= total * fraction) return i / 10.0;
+    }
+    return 0.0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *host = "127.0.0.1";
+    int port = NETWORK_PORT, games = 10000, seconds = 60;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--host") == 0) host = argv[i + 1];
+        else if (strcmp(argv[i], "--port") == 0) port = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--games") == 0) games = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seconds") == 0) seconds = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--move-ms") == 0) s_moveIntervalMs = atoi(argv[i + 1]);
+    }
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) { limit.rlim_cur = limit.rlim_max; setrlimit(RLIMIT_NOFILE, &limit); }
+
+    s_server = (struct sockaddr_in){.sin_family = AF_INET, .sin_port = htons(port)};
+    inet_pton(AF_INET, host, &s_server.sin_addr);
+    s_epollFd = epoll_create1(0);
+
+    int playerCount = games * 2;
+    Player *players = calloc(playerCount, sizeof(Player));
+    for (int i = 0; i < playerCount; i++) players[i].fd = -1;
+
+    struct epoll_event events[1024];
+    long long startMs = Loadgen_NowUs() / 1000, lastReport = startMs;
+    long lastMoves = 0;
+    int nextToConnect = 0;
+    for (;;) {
+        long long nowMs = Loadgen_NowUs() / 1000;
+        if (nowMs - startMs >= seconds * 1000LL) break;
+
+        // Ramp up gradually so the listen backlog never overflows.
+        for (int i = 0; i < LOADGEN_CONNECTS_PER_TICK && nextToConnect < playerCount; i++) Loadgen_Connect(&players[nextToConnect++]);
+
+        int n = epoll_wait(s_epollFd, events, 1024, 5);
+        for (int i = 0; i < n; i++) {
+            Player *player = events[i].data.ptr;
+            if (player->fd < 0) continue;
+            if (player->isConnecting && (events[i].events & EPOLLOUT)) Loadgen_OnConnected(player);
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) Loadgen_Read(player);
+        }
+
+        int connected = 0, playing = 0;
+        for (int i = 0; i < nextToConnect; i++) {
+            Player *player = &players[i];
+            if (player->fd >= 0 && player->isOver) { s_gamesFinished += (player->seat == 0); Loadgen_Disconnect(player); }
+            if (player->fd < 0) { Loadgen_Connect(player); continue; }
+            connected++;
+            if (player->seat == 0 && player->isOpponentReady && !player->isOver) playing++;
+            Loadgen_MaybeMove(player, nowMs);
+        }
+
+        if (nowMs - lastReport >= 1000) {
+            printf("Loadgen: %d connected, %d games in play, %.0f moves/s, p50 %.1f ms, p99 %.1f ms, %ld games finished, %ld failures\n",
+                   connected, playing, (s_moves - lastMoves) * 1000.0 / (nowMs - lastReport), Loadgen_Percentile(0.5),
+                   Loadgen_Percentile(0.99), s_gamesFinished, s_failures);
+            fflush(stdout);
+            lastMoves = s_moves;
+            lastReport = nowMs;
+        }
+    }
+    printf("Loadgen summary: %ld moves acknowledged, move->STATE p50 %.1f ms, p99 %.1f ms, %ld games finished, %ld failures\n",
+           s_moves, Loadgen_Percentile(0.5), Loadgen_Percentile(0.99), s_gamesFinished, s_failures);
+    return 0;
+}
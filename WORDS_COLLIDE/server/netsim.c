@@ -0,0 +1,259 @@
+// Scripted netcode scenarios under simulated network conditions (Linux only).
+//
+//   gcc -O2 server/netsim.c src/network.c src/logic.c src/input.c src/audio.c src/protocol.c src/rules.c
+//       src/profiler.c src/replay.c src/board.c src/save.c
+//       -o wc_netsim -lSDL2 -lSDL2_net -lSDL2_mixer -lm
+//   ./wc_netsim [--scenario wifi] [--moves 40] [--port 9121] [--udp] [--verbose]
+//
+// Each scenario forks a host and a joiner that run the real client code (network.c, logic.c
+// and input.c) over loopback, with the impairment shim in network.c delaying, throttling,
+// reordering and dropping what each one receives. Moves are played by feeding the same
+// click/letter/ENTER events a player would. The report gives how long each move took from
+// ENTER on one side to being applied on the other, and how many cells or scores the two
+// boards disagree on once both have stopped. With --udp the joiner uses the UDP transport,
+// and the "lossy" scenario also drops datagrams.
+#define _GNU_SOURCE
+#include "../include/input.h"
+#include "../include/logic.h"
+#include "../include/network.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define NETSIM_CELLS (GRID_COLS * GRID_ROWS)
+#define NETSIM_THINK_MS 50     // pause before each scripted move
+#define NETSIM_FRAME_MS 16     // same pacing as the game loop
+#define NETSIM_SETTLE_MS 2000  // how long both sides keep draining after the last move
+#define NETSIM_TIMEOUT_MS 60000
+
+typedef struct {
+    const char *name;
+    NetImpairment impairment;
+} NetSimScenario;
+
+static const NetSimScenario s_scenarios[] = {
+    {"clean",    {0}},
+    {"lan",      {.latencyMs = 2, .jitterMs = 1}},
+    {"wifi",     {.latencyMs = 15, .jitterMs = 10, .reorderPercent = 5}},
+    {"cellular", {.latencyMs = 60, .jitterMs = 40, .bandwidthKbps = 64, .reorderPercent = 10}},
+    {"flaky",    {.latencyMs = 30, .jitterMs = 10, .disconnectEveryMs = 3000, .disconnectForMs = 1500}},
+    {"lossy",    {.latencyMs = 15, .jitterMs = 10, .lossPercent = 10}},
+};
+#define NETSIM_SCENARIO_COUNT (int)(sizeof(s_scenarios) / sizeof(s_scenarios[0]))
+
+// Written by the two peer processes, read by the parent once both have exited.
+typedef struct {
+    bool isFinished;
+    int movesMade, movesApplied;
+    long long latencyUs[NETSIM_CELLS];
+    char grid[GRID_COLS][GRID_ROWS];
+    int scores[2];
+    int currentPlayer;
+    int disconnects, reorders, losses, resends;
+} NetSimPeer;
+
+typedef struct {
+    long long sentAtUs[NETSIM_CELLS]; // when the mover pressed ENTER, per cell
+    NetSimPeer peers[2];
+} NetSimShared;
+
+static long long NetSim_NowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int NetSim_CompareLatency(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static void NetSim_Send(SDL_Event *event, GameState *game, AppContext *app) {
+    if (game->currentState == STATE_GET_NAMES) Input_HandleNames(event, game, app);
+    else if (game->currentState == STATE_PLAYING) Input_HandleGame(event, game, app);
+}
+
+static void NetSim_PressKey(GameState *game, AppContext *app, SDL_Keycode key) {
+    SDL_Event event = {.type = SDL_KEYDOWN};
+    event.key.keysym.sym = key;
+    NetSim_Send(&event, game, app);
+}
+
+static void NetSim_TypeText(GameState *game, AppContext *app, const char *text) {
+    for (; *text; text++) {
+        SDL_Event event = {.type = SDL_TEXTINPUT};
+        event.text.text[0] = *text;
+        NetSim_Send(&event, game, app);
+    }
+}
+
+// Same click, letter and ENTER sequence a player would use. Returns the cell played.
+static int NetSim_PlayMove(GameState *game, AppContext *app, NetSimShared *shared, int moveNumber) {
+    int cell = (moveNumber * 37) % NETSIM_CELLS;
+    while (game->grid[cell / GRID_ROWS][cell % GRID_ROWS]) cell = (cell + 1) % NETSIM_CELLS;
+    int startX = (WINDOW_WIDTH - (GRID_COLS * TILE_SIZE)) / 2;
+    int startY = 45 + (WINDOW_HEIGHT - 60 - 45 - (GRID_ROWS * TILE_SIZE)) / 2;
+    SDL_Event click = {.type = SDL_MOUSEBUTTONDOWN};
+    click.button.x = startX + (cell / GRID_ROWS) * TILE_SIZE + TILE_SIZE / 2;
+    click.button.y = startY + (cell % GRID_ROWS) * TILE_SIZE + TILE_SIZE / 2;
+    NetSim_Send(&click, game, app);
+    char letter[2] = {"ETAOINSHRDLU"[rand() % 12], '\0'};
+    NetSim_TypeText(game, app, letter);
+    shared->sentAtUs[cell] = NetSim_NowUs();
+    NetSim_PressKey(game, app, SDLK_RETURN);
+    return cell;
+}
+
+static int NetSim_CountPlaced(const GameState *game) {
+    int placed = 0;
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++) placed += game->grid[x][y] != '\0';
+    return placed;
+}
+
+static void NetSim_RunPeer(int seat, const NetSimScenario *scenario, NetSimShared *shared, int port, int moves, bool useUdp) {
+    NetSimPeer *result = &shared->peers[seat];
+    AppContext app = {0};
+    GameState game = {0};
+    SDL_Init(SDL_INIT_TIMER);
+    Network_Init();
+    NetImpairment impairment = scenario->impairment;
+    impairment.seed = 1234 + seat;
+    if (seat == 0) impairment.disconnectEveryMs = 0; // the joiner's drops cut the link for both
+    Network_SetImpairment(&impairment);
+    if (useUdp) Network_SetTransport(NET_TRANSPORT_UDP);
+    Logic_InitGameState(&game);
+    game.simTime = SDL_GetTicks(); // no fixed-timestep loop here; logic stamps turns with this
+    Logic_LoadDictionary();
+    srand(99 + seat);
+
+    bool isConnected = seat == 0 ? Network_HostGame(port) : false;
+    for (int attempt = 0; seat == 1 && !isConnected && attempt < 50; attempt++) {
+        isConnected = Network_JoinGame("127.0.0.1", port);
+        if (!isConnected) SDL_Delay(100);
+    }
+    if (!isConnected) { printf("netsim: seat %d could not connect\n", seat); return; }
+    game.isMultiplayer = true;
+    game.localPlayerId = seat;
+    game.currentNameInput = seat;
+    game.currentState = STATE_GET_NAMES;
+    NetSim_TypeText(&game, &app, seat == 0 ? "Host" : "Joiner");
+    NetSim_PressKey(&game, &app, SDLK_RETURN);
+
+    NetMessage messages[NET_MAX_MESSAGES_PER_FRAME];
+    bool isMeasured[NETSIM_CELLS] = {0}; // also set for our own moves, which a resync may echo back
+    Uint32 startedAt = SDL_GetTicks(), nextMoveAt = 0, settleUntil = 0;
+    while (SDL_GetTicks() - startedAt < NETSIM_TIMEOUT_MS) {
+        game.simTime = SDL_GetTicks();
+        int count = Network_ReceiveMessages(messages, NET_MAX_MESSAGES_PER_FRAME);
+        for (int i = 0; i < count; i++) {
+            Logic_HandleNetworkMessage(&game, &app, &messages[i].message);
+            Network_MarkApplied(&messages[i]);
+            const GameMessage *applied = &messages[i].message;
+            if (applied->type != MSG_MOVE && applied->type != MSG_STATE) continue;
+            int cell = applied->type == MSG_MOVE ? applied->move.x * GRID_ROWS + applied->move.y
+                                                 : applied->state.x * GRID_ROWS + applied->state.y;
+            if (cell < 0 || cell >= NETSIM_CELLS || isMeasured[cell] || shared->sentAtUs[cell] == 0) continue;
+            isMeasured[cell] = true;
+            result->latencyUs[result->movesApplied++] = NetSim_NowUs() - shared->sentAtUs[cell];
+        }
+        Logic_UpdateConnection(&game);
+
+        Uint32 now = SDL_GetTicks();
+        bool isDone = game.currentState != STATE_PLAYING && game.currentState != STATE_GET_NAMES &&
+                      game.currentState != STATE_WAITING_FOR_OPPONENT;
+        if (NetSim_CountPlaced(&game) >= moves || isDone) {
+            if (settleUntil == 0) settleUntil = now + NETSIM_SETTLE_MS;
+            else if (now >= settleUntil) break;
+        } else if (game.currentState == STATE_PLAYING && game.currentPlayer == seat && !game.isReconnecting) {
+            if (nextMoveAt == 0) nextMoveAt = now + NETSIM_THINK_MS;
+            if (now >= nextMoveAt) {
+                isMeasured[NetSim_PlayMove(&game, &app, shared, NetSim_CountPlaced(&game))] = true;
+                result->movesMade++;
+                nextMoveAt = 0;
+            }
+        }
+        SDL_Delay(NETSIM_FRAME_MS);
+    }
+
+    NetworkStats stats;
+    Network_GetStats(&stats);
+    result->disconnects = stats.simulatedDisconnects;
+    result->reorders = stats.simulatedReorders;
+    result->losses = stats.simulatedLosses;
+    result->resends = stats.reliableResends;
+    memcpy(result->grid, game.grid, sizeof(result->grid));
+    result->scores[0] = game.scores[0];
+    result->scores[1] = game.scores[1];
+    result->currentPlayer = game.currentPlayer;
+    result->isFinished = settleUntil != 0;
+    Network_Cleanup();
+    SDL_Quit();
+}
+
+static void NetSim_Report(const NetSimScenario *scenario, const NetSimShared *shared) {
+    const NetSimPeer *host = &shared->peers[0], *joiner = &shared->peers[1];
+    static long long latencies[2 * NETSIM_CELLS];
+    int count = 0;
+    for (int seat = 0; seat < 2; seat++)
+        for (int i = 0; i < shared->peers[seat].movesApplied; i++) latencies[count++] = shared->peers[seat].latencyUs[i];
+    qsort(latencies, count, sizeof(latencies[0]), NetSim_CompareLatency);
+
+    int desyncs = 0;
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++) desyncs += host->grid[x][y] != joiner->grid[x][y];
+    desyncs += (host->scores[0] != joiner->scores[0]) + (host->scores[1] != joiner->scores[1]);
+    desyncs += host->currentPlayer != joiner->currentPlayer;
+    int moves = host->movesMade + joiner->movesMade;
+
+    printf("%-9s %5d %7d %8.1f %8.1f %8.1f %8d %6d %8d %6d %7d  %s\n", scenario->name, moves, count,
+           count ? latencies[count / 2] / 1000.0 : 0.0, count ? latencies[count * 95 / 100] / 1000.0 : 0.0,
+           count ? latencies[count - 1] / 1000.0 : 0.0, desyncs, host->disconnects + joiner->disconnects,
+           host->reorders + joiner->reorders, host->losses + joiner->losses, host->resends + joiner->resends,
+           host->isFinished && joiner->isFinished ? "ok" : "TIMEOUT");
+}
+
+int main(int argc, char **argv) {
+    const char *only = NULL;
+    int port = 9121, moves = 40;
+    bool isVerbose = false, useUdp = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc) only = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc) port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--moves") == 0 && i + 1 < argc) moves = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--udp") == 0) useUdp = true;
+        else if (strcmp(argv[i], "--verbose") == 0) isVerbose = true;
+    }
+    if (moves > NETSIM_CELLS * MAX_BOARD_FILL) moves = (int)(NETSIM_CELLS * MAX_BOARD_FILL);
+
+    NetSimShared *shared = mmap(NULL, sizeof(NetSimShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) { perror("mmap"); return 1; }
+    printf("%s transport\n", useUdp ? "UDP" : "TCP");
+    printf("scenario  moves applied  p50 ms   p95 ms   max ms  desyncs  drops reorders  lost resends  result\n");
+    int failures = 0;
+    for (int s = 0; s < NETSIM_SCENARIO_COUNT; s++) {
+        if (only && strcmp(only, s_scenarios[s].name) != 0) continue;
+        memset(shared, 0, sizeof(*shared));
+        fflush(stdout);
+        pid_t peers[2];
+        for (int seat = 0; seat < 2; seat++) {
+            peers[seat] = fork();
+            if (peers[seat] == 0) {
+                if (!isVerbose) freopen("/dev/null", "w", stdout);
+                NetSim_RunPeer(seat, &s_scenarios[s], shared, port + s, moves, useUdp);
+                fflush(stdout);
+                _exit(0);
+            }
+            usleep(200000); // the host is listening before the joiner dials
+        }
+        for (int seat = 0; seat < 2; seat++) waitpid(peers[seat], NULL, 0);
+        NetSim_Report(&s_scenarios[s], shared);
+        if (!shared->peers[0].isFinished || !shared->peers[1].isFinished) failures++;
+    }
+    munmap(shared, sizeof(NetSimShared));
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,475 @@
+// Headless authoritative WORDS COLLIDE server (Linux only).
+//
+//   gcc -O2 -pthread server/server.c src/rules.c src/protocol.c -o wc_server
+//   ./wc_server [--port 9021] [--threads N]
+//
+// One acceptor hands every two consecutive connections to the same event loop,
+// which pairs them into a match. Each loop owns its connections and matches
+// outright, so nothing on the move path is shared between threads.
+#define _GNU_SOURCE
+#include "../include/rules.h"
+#include "../include/protocol.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SERVER_RECV_BUFFER 512
+#define SERVER_SEND_BUFFER 1024
+#define SERVER_MAX_EVENTS 512
+#define SERVER_HANDOFF_CAPACITY 8192
+#define SERVER_STATS_INTERVAL_MS 5000
+
+typedef struct Match Match;
+typedef struct EventLoop EventLoop;
+
+typedef struct {
+    int fd;
+    int seat;
+    Match *match;
+    EventLoop *loop;
+    bool isClosed;
+    bool isDirty;
+    bool wantsWrite;
+    bool sendBinary;
+    bool recvBinary;
+    int recvLen;
+    int sendLen;
+    char recvBuf[SERVER_RECV_BUFFER];
+    char sendBuf[SERVER_SEND_BUFFER];
+} Connection;
+
+struct Match {
+    Connection *seats[2];
+    char grid[GRID_COLS][GRID_ROWS];
+    int scores[2];
+    int currentPlayer;
+    bool ready[2];
+    ReadyPayload names[2]; // replayed to an opponent who connects later
+    bool isOver;
+};
+
+struct EventLoop {
+    int index;
+    int epollFd;
+    int wakeFd;
+    pthread_t thread;
+
+    pthread_mutex_t handoffLock;
+    int handoff[SERVER_HANDOFF_CAPACITY];
+    int handoffCount;
+
+    Match *pendingMatch;
+    Connection **dirty;
+    int dirtyCount, dirtyCapacity;
+    Connection **closed;
+    int closedCount, closedCapacity;
+
+    atomic_int connections;
+    atomic_int activeMatches;
+    atomic_long moves;
+    atomic_long rejectedMoves;
+};
+
+static EventLoop *s_loops = NULL;
+static int s_loopCount = 0;
+
+static long long Server_NowUs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static long long Server_NowMs(void) {
+    return Server_NowUs() / 1000;
+}
+
+static void Server_PushPointer(Connection ***array, int *count, int *capacity, Connection *conn) {
+    if (*count == *capacity) {
+        *capacity = *capacity ? *capacity * 2 : 256;
+        *array = realloc(*array, (size_t)*capacity * sizeof(Connection *));
+    }
+    (*array)[(*count)++] = conn;
+}
+
+static void Server_Close(Connection *conn);
+
+// Output is only appended here; every dirty connection is flushed once per epoll batch.
+static void Server_QueueRaw(Connection *conn, const void *data, int len) {
+    if (conn->isClosed) return;
+    if (conn->sendLen + len > SERVER_SEND_BUFFER) {
+        // A client this far behind is not reading; it must not hold up its opponent.
+        Server_Close(conn);
+        return;
+    }
+    memcpy(conn->sendBuf + conn->sendLen, data, len);
+    conn->sendLen += len;
+    if (!conn->isDirty) {
+        conn->isDirty = true;
+        Server_PushPointer(&conn->loop->dirty, &conn->loop->dirtyCount, &conn->loop->dirtyCapacity, conn);
+    }
+}
+
+static void Server_Send(Connection *conn, const GameMessage *message) {
+    if (!conn || conn->isClosed) return;
+    char frame[PROTOCOL_MAX_FRAME];
+    int len = conn->sendBinary ? Protocol_EncodeBinary(message, (uint8_t *)frame)
+                               : Protocol_EncodeText(message, frame, sizeof(frame));
+    Server_QueueRaw(conn, frame, len);
+}
+
+static void Server_Flush(Connection *conn) {
+    conn->isDirty = false;
+    if (conn->isClosed) return;
+    int sent = 0;
+    while (sent < conn->sendLen) {
+        ssize_t n = send(conn->fd, conn->sendBuf + sent, conn->sendLen - sent, MSG_NOSIGNAL);
+        if (n > 0) { sent += (int)n; continue; }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        Server_Close(conn);
+        return;
+    }
+    conn->sendLen -= sent;
+    if (conn->sendLen > 0) memmove(conn->sendBuf, conn->sendBuf + sent, conn->sendLen);
+
+    bool wantsWrite = conn->sendLen > 0;
+    if (wantsWrite != conn->wantsWrite) {
+        struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP | (wantsWrite ? EPOLLOUT : 0), .data.ptr = conn};
+        epoll_ctl(conn->loop->epollFd, EPOLL_CTL_MOD, conn->fd, &ev);
+        conn->wantsWrite = wantsWrite;
+    }
+}
+
+static void Server_ReleaseSeat(Connection *conn) {
+    Match *match = conn->match;
+    if (!match) return;
+    EventLoop *loop = conn->loop;
+    Connection *opponent = match->seats[1 - conn->seat];
+    if (opponent && !match->isOver) {
+        GameMessage forfeit = {.type = MSG_GIVE_UP, .giveUp = {(uint8_t)conn->seat}};
+        Server_Send(opponent, &forfeit);
+    }
+    if (!match->isOver) atomic_fetch_sub(&loop->activeMatches, 1);
+    match->isOver = true;
+    match->seats[conn->seat] = NULL;
+    conn->match = NULL;
+    if (loop->pendingMatch == match) loop->pendingMatch = NULL;
+    if (!match->seats[0] && !match->seats[1]) free(match);
+}
+
+static void Server_Close(Connection *conn) {
+    if (conn->isClosed) return;
+    conn->isClosed = true;
+    Server_ReleaseSeat(conn);
+    epoll_ctl(conn->loop->epollFd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    atomic_fetch_sub(&conn->loop->connections, 1);
+    // Freed after the batch, because the event list may still point at it.
+    Server_PushPointer(&conn->loop->closed, &conn->loop->closedCount, &conn->loop->closedCapacity, conn);
+}
+
+static void Server_HandleMove(Connection *conn, const MovePayload *move) {
+    Match *match = conn->match;
+    EventLoop *loop = conn->loop;
+    if (!match || match->isOver || !match->ready[0] || !match->ready[1] || match->currentPlayer != conn->seat ||
+        !Rules_IsLegalMove(match->grid, move->x, move->y, move->letter)) {
+        atomic_fetch_add(&loop->rejectedMoves, 1);
+        return;
+    }
+    match->grid[move->x][move->y] = move->letter;
+    match->scores[conn->seat] += Rules_ScorePlacement(match->grid, move->x, move->y, move->letter);
+    match->currentPlayer = 1 - conn->seat;
+    atomic_fetch_add(&loop->moves, 1);
+
+    if (Rules_CheckEnd(match->grid, match->scores) != END_NONE) {
+        match->isOver = true;
+        atomic_fetch_sub(&loop->activeMatches, 1);
+    }
+
+    // Sending can close a slow seat and free the match, so it is not touched afterwards.
+    // The server's clock is the shared timebase its clients sync to, so the next turn starts now.
+    GameMessage state = {.type = MSG_STATE};
+    state.state = Protocol_MakeState(move->x, move->y, move->letter, match->currentPlayer, match->scores, (uint32_t)Server_NowMs());
+    Connection *seat0 = match->seats[0], *seat1 = match->seats[1];
+    Server_Send(seat0, &state);
+    Server_Send(seat1, &state);
+}
+
+// The sender's seat always comes from the connection, never from the payload.
+static void Server_HandleMessage(Connection *conn, GameMessage *message) {
+    Match *match = conn->match;
+    Connection *opponent = match ? match->seats[1 - conn->seat] : NULL;
+    switch (message->type) {
+        case MSG_READY:
+        case MSG_READY_ACK:
+            if (!match) return;
+            message->ready.playerId = (uint8_t)conn->seat;
+            match->names[conn->seat] = message->ready;
+            match->ready[conn->seat] = true;
+            Server_Send(opponent, message);
+            break;
+        case MSG_MOVE:
+            Server_HandleMove(conn, &message->move);
+            break;
+        case MSG_PAUSE_ON:
+        case MSG_PAUSE_OFF:
+            Server_Send(opponent, message);
+            break;
+        case MSG_GIVE_UP:
+            if (!match || match->isOver) return;
+            message->giveUp.playerId = (uint8_t)conn->seat;
+            match->isOver = true;
+            atomic_fetch_sub(&conn->loop->activeMatches, 1);
+            Server_Send(opponent, message);
+            break;
+        case MSG_PING: {
+            // The server is the reference clock for its matches.
+            GameMessage pong = {.type = MSG_PONG};
+            memcpy(pong.pong.t0, message->ping.t0, sizeof(pong.pong.t0));
+            Protocol_PutU64(pong.pong.t1, (uint64_t)Server_NowUs());
+            memcpy(pong.pong.t2, pong.pong.t1, sizeof(pong.pong.t2));
+            Server_Send(conn, &pong);
+            break;
+        }
+        default:
+            break; // ASSIGN, STATE and the rest only travel server -> client
+    }
+}
+
+// Same handshake as the game client: a HELLO line each way, then HELLO_ACK flips a direction to binary.
+static bool Server_HandleHandshake(Connection *conn, const char *line) {
+    int version = 0;
+    if (sscanf(line, "HELLO,%d", &version) == 1) {
+        if (version >= 2 && !conn->sendBinary) {
+            Server_QueueRaw(conn, "HELLO_ACK\n", 10);
+            conn->sendBinary = true;
+        }
+        return true;
+    }
+    if (strcmp(line, "HELLO_ACK") == 0) {
+        conn->recvBinary = true;
+        return true;
+    }
+    return false;
+}
+
+static void Server_ParseInput(Connection *conn) {
+    int pos = 0;
+    while (!conn->isClosed && pos < conn->recvLen) {
+        GameMessage message;
+        bool isValid;
+        if (conn->recvBinary) {
+            if (conn->recvLen - pos < 2) break;
+            int bodyLen = ((uint8_t)conn->recvBuf[pos] << 8) | (uint8_t)conn->recvBuf[pos + 1];
+            if (bodyLen == 0 || bodyLen > PROTOCOL_MAX_FRAME) { Server_Close(conn); return; }
+            if (conn->recvLen - pos < 2 + bodyLen) break;
+            isValid = Protocol_DecodeBinary((const uint8_t *)conn->recvBuf + pos + 2, bodyLen, &message);
+            pos += 2 + bodyLen;
+        } else {
+            char *newline = memchr(conn->recvBuf + pos, '\n', conn->recvLen - pos);
+            if (!newline) break;
+            *newline = '\0';
+            const char *line = conn->recvBuf + pos;
+            pos = (int)(newline - conn->recvBuf) + 1;
+            if (Server_HandleHandshake(conn, line)) continue;
+            isValid = Protocol_DecodeText(line, &message);
+        }
+        if (isValid) Server_HandleMessage(conn, &message);
+    }
+    if (conn->isClosed) return;
+    conn->recvLen -= pos;
+    if (conn->recvLen > 0) memmove(conn->recvBuf, conn->recvBuf + pos, conn->recvLen);
+    if (conn->recvLen == SERVER_RECV_BUFFER) Server_Close(conn); // a line longer than the buffer
+}
+
+static void Server_Read(Connection *conn) {
+    for (;;) {
+        ssize_t n = recv(conn->fd, conn->recvBuf + conn->recvLen, SERVER_RECV_BUFFER - conn->recvLen, 0);
+        if (n > 0) {
+            conn->recvLen += (int)n;
+            Server_ParseInput(conn);
+            if (conn->isClosed) return;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        Server_Close(conn);
+        return;
+    }
+}
+
+static void Server_Attach(EventLoop *loop, int fd) {
+    Connection *conn = calloc(1, sizeof(Connection));
+    if (!conn) { close(fd); return; }
+    conn->fd = fd;
+    conn->loop = loop;
+    struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP, .data.ptr = conn};
+    if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) { close(fd); free(conn); return; }
+    atomic_fetch_add(&loop->connections, 1);
+
+    Match *match = loop->pendingMatch;
+    if (match) {
+        loop->pendingMatch = NULL;
+        conn->seat = 1;
+    } else {
+        match = calloc(1, sizeof(Match));
+        loop->pendingMatch = match;
+        conn->seat = 0;
+        atomic_fetch_add(&loop->activeMatches, 1);
+    }
+    match->seats[conn->seat] = conn;
+    conn->match = match;
+
+    char hello[32];
+    Server_QueueRaw(conn, hello, sprintf(hello, "HELLO,%d\n", PROTOCOL_VERSION));
+    GameMessage assign = {.type = MSG_ASSIGN, .assign = {(uint8_t)conn->seat}};
+    Server_Send(conn, &assign);
+    if (conn->seat == 1 && match->ready[0]) {
+        GameMessage ready = {.type = MSG_READY, .ready = match->names[0]};
+        Server_Send(conn, &ready);
+    }
+}
+
+static void Server_DrainHandoff(EventLoop *loop) {
+    uint64_t counter;
+    if (read(loop->wakeFd, &counter, sizeof(counter)) < 0 && errno != EAGAIN) return;
+    int fds[SERVER_HANDOFF_CAPACITY];
+    pthread_mutex_lock(&loop->handoffLock);
+    int count = loop->handoffCount;
+    memcpy(fds, loop->handoff, count * sizeof(int));
+    loop->handoffCount = 0;
+    pthread_mutex_unlock(&loop->handoffLock);
+    for (int i = 0; i < count; i++) Server_Attach(loop, fds[i]);
+}
+
+static void *Server_LoopMain(void *arg) {
+    EventLoop *loop = arg;
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    for (;;) {
+        int n = epoll_wait(loop->epollFd, events, SERVER_MAX_EVENTS, -1);
+        if (n < 0 && errno != EINTR) break;
+        for (int i = 0; i < n; i++) {
+            Connection *conn = events[i].data.ptr;
+            if (!conn) { Server_DrainHandoff(loop); continue; }
+            if (conn->isClosed) continue;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) Server_Read(conn);
+            if (!conn->isClosed && (events[i].events & EPOLLOUT) && !conn->isDirty) {
+                conn->isDirty = true;
+                Server_PushPointer(&loop->dirty, &loop->dirtyCount, &loop->dirtyCapacity, conn);
+            }
+        }
+        // Flushing can close connections, which only ever appends to the closed list.
+        for (int i = 0; i < loop->dirtyCount; i++) Server_Flush(loop->dirty[i]);
+        loop->dirtyCount = 0;
+        for (int i = 0; i < loop->closedCount; i++) free(loop->closed[i]);
+        loop->closedCount = 0;
+    }
+    return NULL;
+}
+
+static bool Server_Handoff(EventLoop *loop, int fd) {
+    pthread_mutex_lock(&loop->handoffLock);
+    bool hasRoom = loop->handoffCount < SERVER_HANDOFF_CAPACITY;
+    if (hasRoom) loop->handoff[loop->handoffCount++] = fd;
+    pthread_mutex_unlock(&loop->handoffLock);
+    if (!hasRoom) return false;
+    uint64_t one = 1;
+    if (write(loop->wakeFd, &one, sizeof(one)) < 0) perror("eventfd write");
+    return true;
+}
+
+static void Server_PrintStats(double seconds, long *lastMoves) {
+    int connections = 0, matches = 0;
+    long moves = 0, rejected = 0;
+    for (int i = 0; i < s_loopCount; i++) {
+        connections += atomic_load(&s_loops[i].connections);
+        matches += atomic_load(&s_loops[i].activeMatches);
+        moves += atomic_load(&s_loops[i].moves);
+        rejected += atomic_load(&s_loops[i].rejectedMoves);
+    }
+    printf("Server: %d connections, %d active matches, %.0f moves/s, %ld moves total, %ld rejected\n",
+           connections, matches, (moves - *lastMoves) / seconds, moves, rejected);
+    fflush(stdout);
+    *lastMoves = moves;
+}
+
+static void Server_RaiseFileLimit(void) {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+        printf("Server: file descriptor limit %llu (about %llu concurrent matches)\n",
+               (unsigned long long)limit.rlim_cur, (unsigned long long)(limit.rlim_cur / 2));
+}
+
+int main(int argc, char *argv[]) {
+    int port = NETWORK_PORT;
+    s_loopCount = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--port") == 0) port = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--threads") == 0) s_loopCount = atoi(argv[i + 1]);
+    }
+    if (s_loopCount < 1) s_loopCount = 1;
+
+    signal(SIGPIPE, SIG_IGN);
+    Server_RaiseFileLimit();
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    int yes = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_ANY)};
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+        perror("listen");
+        return 1;
+    }
+
+    s_loops = calloc(s_loopCount, sizeof(EventLoop));
+    for (int i = 0; i < s_loopCount; i++) {
+        EventLoop *loop = &s_loops[i];
+        loop->index = i;
+        loop->epollFd = epoll_create1(0);
+        loop->wakeFd = eventfd(0, EFD_NONBLOCK);
+        pthread_mutex_init(&loop->handoffLock, NULL);
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+        epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->wakeFd, &ev);
+        pthread_create(&loop->thread, NULL, Server_LoopMain, loop);
+    }
+    printf("Server: listening on port %d with %d event loop(s)\n", port, s_loopCount);
+
+    long accepted = 0, lastMoves = 0;
+    long long lastStats = Server_NowMs();
+    for (;;) {
+        struct pollfd pfd = {.fd = listenFd, .events = POLLIN};
+        if (poll(&pfd, 1, 1000) > 0) {
+            int fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK);
+            if (fd >= 0) {
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+                // Two consecutive connections land on the same loop and become one match.
+                if (Server_Handoff(&s_loops[(accepted / 2) % s_loopCount], fd)) accepted++;
+                else close(fd);
+            } else if (errno == EMFILE || errno == ENFILE) {
+                usleep(10000);
+            }
+        }
+        long long now = Server_NowMs();
+        if (now - lastStats >= SERVER_STATS_INTERVAL_MS) {
+            Server_PrintStats((now - lastStats) / 1000.0, &lastMoves);
+            lastStats = now;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "../include/assets.h"
+#include "../include/audio.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define ASSETS_FONT_PATH "assets/arial.ttf"
+
+typedef enum { ASSET_LANE_FONTS, ASSET_LANE_AUDIO, ASSET_LANE_COUNT } AssetLane;
+
+// Priority order within each lane: the fonts every screen needs, then the sounds a move
+// triggers, then the rarer ones, then music.
+static const struct {
+    AssetId id;
+    AssetLane lane;
+    const char *name, *path;
+    int fontSize;
+} assetJobs[] = {
+    {ASSET_FONT_LARGE, ASSET_LANE_FONTS, "large font", ASSETS_FONT_PATH, 52},
+    {ASSET_FONT_REGULAR, ASSET_LANE_FONTS, "regular font", ASSETS_FONT_PATH, 24},
+    {ASSET_SFX_PLACE_TILE, ASSET_LANE_AUDIO, "place sound", "assets/place.wav", 0},
+    {ASSET_SFX_VALID_WORD, ASSET_LANE_AUDIO, "valid word sound", "assets/success.wav", 0},
+    {ASSET_SFX_WARNING, ASSET_LANE_AUDIO, "warning sound", "assets/warning.wav", 0},
+    {ASSET_SFX_WIN, ASSET_LANE_AUDIO, "win sound", "assets/win.wav", 0},
+    {ASSET_BGM_WELCOME, ASSET_LANE_AUDIO, "welcome music", "assets/welcome.mp3", 0},
+};
+
+static void *assets[ASSET_COUNT];
+static SDL_atomic_t isLanded[ASSET_COUNT];
+static SDL_Thread *loaders[ASSET_LANE_COUNT];
+static Uint64 launchedAt;
+// Both font sizes are opened from one read of the file, which has to outlive them.
+static void *fontFile = NULL;
+static size_t fontFileSize = 0;
+
+static double Assets_MsSinceLaunch(void) {
+    return (SDL_GetPerformanceCounter() - launchedAt) * 1000.0 / SDL_GetPerformanceFrequency();
+}
+
+static void *Assets_Load(size_t job) {
+    const char *path = assetJobs[job].path;
+    if (assetJobs[job].lane == ASSET_LANE_FONTS) {
+        if (!fontFile) fontFile = SDL_LoadFile(path, &fontFileSize);
+        return fontFile ? TTF_OpenFontRW(SDL_RWFromConstMem(fontFile, (int)fontFileSize), 1, assetJobs[job].fontSize) : NULL;
+    }
+    if (assetJobs[job].id == ASSET_BGM_WELCOME) return Mix_LoadMUS(path);
+    return Mix_LoadWAV(path);
+}
+
+static int Assets_LoaderMain(void *data) {
+    AssetLane lane = (AssetLane)(intptr_t)data;
+    bool isUsable = true;
+    if (lane == ASSET_LANE_AUDIO) {
+        isUsable = Audio_Init();
+        if (isUsable) printf("Assets: %-16s ready %6.1f ms after launch\n", "audio device", Assets_MsSinceLaunch());
+        else printf("Assets: no audio device (%s), playing silently\n", Mix_GetError());
+    }
+    for (size_t job = 0; job < sizeof(assetJobs) / sizeof(assetJobs[0]); job++) {
+        if (assetJobs[job].lane != lane) continue;
+        AssetId id = assetJobs[job].id;
+        assets[id] = isUsable ? Assets_Load(job) : NULL;
+        SDL_AtomicSet(&isLanded[id], 1); // publishes assets[id] to the resolving thread
+        if (assets[id]) printf("Assets: %-16s ready %6.1f ms after launch\n", assetJobs[job].name, Assets_MsSinceLaunch());
+        else if (isUsable) printf("Assets: could not load %s: %s\n", assetJobs[job].path, SDL_GetError());
+    }
+    return 0;
+}
+
+void Assets_StartLoading(const AppContext *app) {
+    launchedAt = app->launchedAt;
+    static const char *threadNames[ASSET_LANE_COUNT] = {"load fonts", "load audio"};
+    for (int lane = 0; lane < ASSET_LANE_COUNT; lane++) {
+        loaders[lane] = SDL_CreateThread(Assets_LoaderMain, threadNames[lane], (void *)(intptr_t)lane);
+        if (!loaders[lane]) Assets_LoaderMain((void *)(intptr_t)lane); // no thread: load in place
+    }
+}
+
+bool Assets_IsReady(AssetId id) {
+    return SDL_AtomicGet(&isLanded[id]) != 0;
+}
+
+void *Assets_Get(AssetId id) {
+    return Assets_IsReady(id) ? assets[id] : NULL;
+}
+
+void Assets_ResolveFonts(AppContext *app) {
+    if (app->fontLarge || app->fontRegular || !Assets_IsReady(ASSET_FONT_LARGE) || !Assets_IsReady(ASSET_FONT_REGULAR))
+        return;
+    app->fontLarge = Assets_Get(ASSET_FONT_LARGE);
+    app->fontRegular = Assets_Get(ASSET_FONT_REGULAR);
+}
+
+void Assets_ResolveAudio(AppContext *app) {
+    if (!app->sfxPlaceTile) app->sfxPlaceTile = Assets_Get(ASSET_SFX_PLACE_TILE);
+    if (!app->sfxValidWord) app->sfxValidWord = Assets_Get(ASSET_SFX_VALID_WORD);
+    if (!app->sfxWarning) app->sfxWarning = Assets_Get(ASSET_SFX_WARNING);
+    if (!app->sfxWin) app->sfxWin = Assets_Get(ASSET_SFX_WIN);
+    if (!app->bgmWelcome) app->bgmWelcome = Assets_Get(ASSET_BGM_WELCOME);
+}
+
+void Assets_FinishLoading(AppContext *app) {
+    for (int lane = 0; lane < ASSET_LANE_COUNT; lane++) {
+        if (loaders[lane]) SDL_WaitThread(loaders[lane], NULL);
+        loaders[lane] = NULL;
+    }
+    Assets_ResolveFonts(app);
+    Assets_ResolveAudio(app);
+}
+
+void Assets_Cleanup(AppContext *app) {
+    if (app->fontLarge) TTF_CloseFont(app->fontLarge);
+    if (app->fontRegular) TTF_CloseFont(app->fontRegular);
+    app->fontLarge = app->fontRegular = NULL;
+    SDL_free(fontFile);
+    fontFile = NULL;
+}
@@ -1,24 +1,172 @@
 #include "../include/audio.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-bool Audio_Init(AppContext *app) {
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) return false;
-    app->sfxPlaceTile = Mix_LoadWAV("assets/place.wav");
-    app->sfxValidWord = Mix_LoadWAV("assets/success.wav");
-    app->sfxWarning   = Mix_LoadWAV("assets/warning.wav");
-    app->sfxWin       = Mix_LoadWAV("assets/win.wav");
-    app->bgmWelcome   = Mix_LoadMUS("assets/welcome.mp3"); 
+#define AUDIO_LATENCY_SAMPLES 1024
+#define AUDIO_BENCH_TRIGGERS 120
+
+static SDL_atomic_t isDeviceOpen;
+static int deviceFrequency, deviceChannels, bufferSamples;
+static Uint16 deviceFormat;
+static Uint64 bufferTicks;
+
+// Trigger-to-mix measurement. The game thread writes a channel's triggeredAt itself, outside
+// any lock, but only once Mix_GroupAvailable has found the channel free (so the effect that
+// reads it has been removed) and before Mix_RegisterEffect adds it again. Both calls take the
+// mixer lock, which orders the write against the audio thread. The latency samples are
+// audio-thread only.
+static Uint64 triggeredAt[AUDIO_MIXER_CHANNELS];
+static Uint32 latencyUs[AUDIO_LATENCY_SAMPLES];
+static Uint64 lastCallbackAt;
+static SDL_atomic_t latencyCount, lastLatencyUs, triggers, callbacks, underruns;
+
+static int Audio_BufferSamplesFromEnv(void) {
+    const char *value = SDL_getenv("WORDS_COLLIDE_AUDIO_BUFFER");
+    int samples = value ? atoi(value) : AUDIO_DEFAULT_BUFFER_SAMPLES;
+    if (samples < AUDIO_MIN_BUFFER_SAMPLES) samples = AUDIO_MIN_BUFFER_SAMPLES;
+    if (samples > AUDIO_MAX_BUFFER_SAMPLES) samples = AUDIO_MAX_BUFFER_SAMPLES;
+    while (samples & (samples - 1)) samples &= samples - 1;
+    return samples;
+}
+
+// Runs after every mix. A callback that comes more than one and a half buffers after the
+// last means the device had played out what it was given before it got more.
+static void Audio_OnMixed(void *data, Uint8 *stream, int length) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (lastCallbackAt && (now - lastCallbackAt) * 2 > bufferTicks * 3) SDL_AtomicAdd(&underruns, 1);
+    lastCallbackAt = now;
+    SDL_AtomicAdd(&callbacks, 1);
+}
+
+static void Audio_OnChannelMixed(int channel, void *stream, int length, void *data) {
+    if (channel < 0 || channel >= AUDIO_MIXER_CHANNELS || !triggeredAt[channel]) return;
+    Uint32 us = (Uint32)((SDL_GetPerformanceCounter() - triggeredAt[channel]) * 1000000 / SDL_GetPerformanceFrequency());
+    triggeredAt[channel] = 0;
+    latencyUs[SDL_AtomicAdd(&latencyCount, 1) % AUDIO_LATENCY_SAMPLES] = us;
+    SDL_AtomicSet(&lastLatencyUs, (int)us);
+}
+
+// The mixer takes the device's own rate, format and channel count, so SDL adds no conversion
+// stage after mixing, and Mix_LoadWAV converts each chunk to that format once, at load time:
+// nothing is resampled when a sound is triggered. Only the buffer size is fixed.
+bool Audio_Open(int samples) {
+    int allowedChanges = SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_FORMAT_CHANGE | SDL_AUDIO_ALLOW_CHANNELS_CHANGE;
+    if (Mix_OpenAudioDevice(44100, MIX_DEFAULT_FORMAT, 2, samples, NULL, allowedChanges) < 0) return false;
+    Mix_QuerySpec(&deviceFrequency, &deviceFormat, &deviceChannels);
+    Mix_AllocateChannels(AUDIO_MIXER_CHANNELS);
+    bufferSamples = samples;
+    bufferTicks = SDL_GetPerformanceFrequency() * samples / deviceFrequency;
+    memset(triggeredAt, 0, sizeof(triggeredAt));
+    lastCallbackAt = 0;
+    SDL_AtomicSet(&latencyCount, 0);
+    SDL_AtomicSet(&lastLatencyUs, 0);
+    SDL_AtomicSet(&triggers, 0);
+    SDL_AtomicSet(&callbacks, 0);
+    SDL_AtomicSet(&underruns, 0);
+    Mix_SetPostMix(Audio_OnMixed, NULL);
+    SDL_AtomicSet(&isDeviceOpen, 1);
+    printf("Audio: %d Hz, %d channels, %d-sample buffer (%.1f ms)\n", deviceFrequency, deviceChannels, samples, samples * 1000.0 / deviceFrequency);
     return true;
 }
 
-void Audio_PlaySound(Mix_Chunk *sound) { if (sound) Mix_PlayChannel(-1, sound, 0); }
+bool Audio_Init(void) {
+    return Audio_Open(Audio_BufferSamplesFromEnv());
+}
+
+// Sounds and music are NULL until their asset has landed, so early calls are no-ops. The sound
+// goes on a free channel picked here so the latency probe can be attached before it starts.
+void Audio_PlaySound(Mix_Chunk *sound) {
+    if (!sound) return;
+    int channel = Mix_GroupAvailable(-1);
+    if (channel < 0 || channel >= AUDIO_MIXER_CHANNELS) return; // every channel busy, as Mix_PlayChannel(-1) would find
+    triggeredAt[channel] = SDL_GetPerformanceCounter();
+    Mix_RegisterEffect(channel, Audio_OnChannelMixed, NULL, NULL); // dropped by the mixer when the channel finishes
+    Mix_PlayChannel(channel, sound, 0);
+    SDL_AtomicAdd(&triggers, 1);
+}
 void Audio_PlayMusic(Mix_Music *music) { if (music) Mix_PlayMusic(music, -1); }
-void Audio_StopMusic(void) { Mix_HaltMusic(); }
+void Audio_StopMusic(void) { if (SDL_AtomicGet(&isDeviceOpen)) Mix_HaltMusic(); }
+
+// The loader thread writes the device fields before it sets isDeviceOpen, so they are only
+// read once it is set; until then the stats are all zero.
+void Audio_GetStats(AudioStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (!SDL_AtomicGet(&isDeviceOpen)) return;
+    stats->bufferSamples = bufferSamples;
+    stats->frequency = deviceFrequency;
+    stats->channels = deviceChannels;
+    stats->triggers = SDL_AtomicGet(&triggers);
+    stats->callbacks = SDL_AtomicGet(&callbacks);
+    stats->underruns = SDL_AtomicGet(&underruns);
+    stats->lastLatencyUs = SDL_AtomicGet(&lastLatencyUs);
+}
+
+static int Audio_CompareUs(const void *a, const void *b) {
+    Uint32 x = *(const Uint32 *)a, y = *(const Uint32 *)b;
+    return (x > y) - (x < y);
+}
+
+// Only once the device is closed, so the audio thread is no longer writing the samples, and
+// before isDeviceOpen is cleared, so the stats are still readable.
+static void Audio_Report(void) {
+    AudioStats stats;
+    Audio_GetStats(&stats);
+    int count = SDL_AtomicGet(&latencyCount);
+    if (count > AUDIO_LATENCY_SAMPLES) count = AUDIO_LATENCY_SAMPLES;
+    printf("Audio: %4d-sample buffer (%4.1f ms): ", stats.bufferSamples, stats.bufferSamples * 1000.0 / stats.frequency);
+    if (count > 0) {
+        qsort(latencyUs, count, sizeof(latencyUs[0]), Audio_CompareUs);
+        printf("trigger to mix p50 %5.2f  p99 %5.2f  max %5.2f ms over %d sounds, ", latencyUs[count / 2] / 1000.0,
+               latencyUs[(count * 99) / 100] / 1000.0, latencyUs[count - 1] / 1000.0, count);
+    }
+    printf("%d underruns in %d callbacks\n", stats.underruns, stats.callbacks);
+}
+
+static void Audio_Close(void) {
+    if (!SDL_AtomicGet(&isDeviceOpen)) return;
+    Mix_CloseAudio();
+    Audio_Report();
+    SDL_AtomicSet(&isDeviceOpen, 0);
+}
 
 void Audio_Cleanup(AppContext *app) {
     if (app->sfxPlaceTile) Mix_FreeChunk(app->sfxPlaceTile);
     if (app->sfxValidWord) Mix_FreeChunk(app->sfxValidWord);
-    if (app->sfxWarning)   Mix_FreeChunk(app->sfxWarning); 
+    if (app->sfxWarning)   Mix_FreeChunk(app->sfxWarning);
     if (app->sfxWin)       Mix_FreeChunk(app->sfxWin);
     if (app->bgmWelcome)   Mix_FreeMusic(app->bgmWelcome);
+    Audio_Close();
+    Mix_Quit();
+}
+
+// Plays a short silent chunk in the device format at uneven intervals, so triggers land at
+// every point in the buffer cycle. The number heard is trigger to mix plus about one buffer.
+int Audio_RunBenchmark(void) {
+    static const int sizes[] = {256, 512, 1024, 2048};
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        printf("Audio benchmark: SDL init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (!Audio_Open(sizes[s])) {
+            printf("Audio benchmark: could not open a %d-sample device: %s\n", sizes[s], Mix_GetError());
+            SDL_Quit();
+            return 1;
+        }
+        Uint32 bytes = (Uint32)(deviceFrequency / 50 * deviceChannels * (SDL_AUDIO_BITSIZE(deviceFormat) / 8)); // 20 ms
+        Uint8 *silence = calloc(1, bytes);
+        Mix_Chunk *chunk = silence ? Mix_QuickLoad_RAW(silence, bytes) : NULL;
+        for (int i = 0; chunk && i < AUDIO_BENCH_TRIGGERS; i++) {
+            Audio_PlaySound(chunk);
+            SDL_Delay(7 + (i * 13) % 29);
+        }
+        SDL_Delay(100);
+        if (chunk) Mix_FreeChunk(chunk);
+        Audio_Close();
+        free(silence);
+    }
     Mix_Quit();
-}
\ No newline at end of file
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,155 @@
+#include "../include/board.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BOARD_BENCH_PAIRS 20000000
+#define BOARD_BENCH_COPIES 2000000
+#define BOARD_BENCH_DEPTH 8
+
+static int Board_Bit(int x, int y) {
+    return x * GRID_ROWS + y;
+}
+
+void Board_SyncOccupancy(BoardState *board) {
+    memset(board->occupancy, 0, sizeof(board->occupancy));
+    board->filled = 0;
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            if (board->grid[x][y]) {
+                board->occupancy[Board_Bit(x, y) / 64] |= (Uint64)1 << (Board_Bit(x, y) % 64);
+                board->filled++;
+            }
+}
+
+void Board_FromGame(BoardState *board, const GameState *game) {
+    memset(board, 0, sizeof(*board));
+    memcpy(board->grid, game->grid, sizeof(board->grid));
+    board->scores[0] = game->scores[0];
+    board->scores[1] = game->scores[1];
+    board->sideToMove = (Uint8)game->currentPlayer;
+    board->scoredWordCount = (Uint16)game->scoredWordCount;
+    Board_SyncOccupancy(board);
+}
+
+void Board_ToGame(const BoardState *board, GameState *game) {
+    memcpy(game->grid, board->grid, sizeof(game->grid));
+    game->scores[0] = board->scores[0];
+    game->scores[1] = board->scores[1];
+    game->currentPlayer = board->sideToMove;
+    game->scoredWordCount = board->scoredWordCount;
+}
+
+bool Board_IsOccupied(const BoardState *board, int x, int y) {
+    int bit = Board_Bit(x, y);
+    return (board->occupancy[bit / 64] >> (bit % 64)) & 1;
+}
+
+static void Board_Place(BoardState *board, int x, int y, char letter, BoardUndo *undo) {
+    int bit = Board_Bit(x, y);
+    undo->x = (Uint8)x;
+    undo->y = (Uint8)y;
+    undo->mover = board->sideToMove;
+    undo->scoredWordCount = board->scoredWordCount;
+    board->grid[x][y] = letter;
+    board->occupancy[bit / 64] |= (Uint64)1 << (bit % 64);
+    board->filled++;
+}
+
+static void Board_Score(BoardState *board, int scoreDelta, BoardUndo *undo) {
+    undo->scoreDelta = (Sint16)scoreDelta;
+    board->scores[undo->mover] += scoreDelta;
+    board->sideToMove = 1 - undo->mover;
+}
+
+int Board_MakeMove(BoardState *board, int x, int y, char letter, BoardUndo *undo) {
+    Board_Place(board, x, y, letter, undo);
+    int score = Rules_ScorePlacement(board->grid, x, y, letter);
+    Board_Score(board, score > 0 ? score : 0, undo);
+    return score;
+}
+
+void Board_MakeScoredMove(BoardState *board, int x, int y, char letter, int scoreDelta, BoardUndo *undo) {
+    Board_Place(board, x, y, letter, undo);
+    Board_Score(board, scoreDelta, undo);
+}
+
+void Board_UnmakeMove(BoardState *board, const BoardUndo *undo) {
+    int bit = Board_Bit(undo->x, undo->y);
+    board->grid[undo->x][undo->y] = '\0';
+    board->occupancy[bit / 64] &= ~((Uint64)1 << (bit % 64));
+    board->filled--;
+    board->scores[undo->mover] -= undo->scoreDelta;
+    board->sideToMove = undo->mover;
+    board->scoredWordCount = undo->scoredWordCount;
+}
+
+void Board_RunBenchmark(void) {
+    static GameState game, scratch;
+    static BoardState board, original;
+    int empty[GRID_COLS * GRID_ROWS][2], emptyCount = 0;
+    srand(7);
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++) {
+            if (rand() % 2) game.grid[x][y] = (char)('A' + rand() % 26);
+            else { empty[emptyCount][0] = x; empty[emptyCount][1] = y; emptyCount++; }
+        }
+    game.scores[0] = 120;
+    game.scores[1] = 110;
+    Board_FromGame(&board, &game);
+    memcpy(&original, &board, sizeof(original));
+
+    // One move tried and taken back, over every empty cell in turn.
+    long checksum = 0;
+    BoardUndo undo;
+    clock_t start = clock();
+    for (int i = 0; i < BOARD_BENCH_PAIRS; i++) {
+        const int *cell = empty[i % emptyCount];
+        checksum += Board_MakeMove(&board, cell[0], cell[1], (char)('A' + i % 26), &undo);
+        checksum += board.scores[0];
+        Board_UnmakeMove(&board, &undo);
+    }
+    double pairSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+    bool isRestored = memcmp(&board, &original, sizeof(board)) == 0;
+
+    // A search line: BOARD_BENCH_DEPTH moves down, then all of them undone.
+    BoardUndo line[BOARD_BENCH_DEPTH];
+    start = clock();
+    for (int i = 0; i < BOARD_BENCH_PAIRS / BOARD_BENCH_DEPTH; i++) {
+        for (int d = 0; d < BOARD_BENCH_DEPTH; d++) {
+            const int *cell = empty[(i + d) % emptyCount]; // distinct while emptyCount >= the depth
+            Board_MakeMove(&board, cell[0], cell[1], (char)('A' + d), &line[d]);
+        }
+        checksum += board.scores[0] + board.scores[1];
+        for (int d = BOARD_BENCH_DEPTH - 1; d >= 0; d--) Board_UnmakeMove(&board, &line[d]);
+    }
+    double lineSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+    isRestored = isRestored && memcmp(&board, &original, sizeof(board)) == 0;
+
+    // And the restored board hands the game back exactly what it was built from.
+    memcpy(&scratch, &game, sizeof(scratch));
+    memset(scratch.grid, 0, sizeof(scratch.grid));
+    scratch.scores[0] = scratch.scores[1] = -1;
+    Board_ToGame(&board, &scratch);
+    isRestored = isRestored && memcmp(&scratch, &game, sizeof(scratch)) == 0;
+
+    // What a search over GameState has to do instead: copy the whole state for every move.
+    start = clock();
+    for (int i = 0; i < BOARD_BENCH_COPIES; i++) {
+        const int *cell = empty[i % emptyCount];
+        memcpy(&scratch, &game, sizeof(scratch));
+        scratch.grid[cell[0]][cell[1]] = (char)('A' + i % 26);
+        int score = Rules_ScorePlacement(scratch.grid, cell[0], cell[1], scratch.grid[cell[0]][cell[1]]);
+        scratch.scores[scratch.currentPlayer] += score > 0 ? score : 0;
+        checksum += scratch.scores[0];
+    }
+    double copySec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("Board benchmark: BoardState %zu bytes (align %zu), GameState %zu bytes, %d empty cells\n",
+           sizeof(BoardState), alignof(BoardState), sizeof(GameState), emptyCount);
+    printf("  make/unmake pairs:        %12.0f /s\n", BOARD_BENCH_PAIRS / pairSec);
+    printf("  depth-%d lines, per move:  %12.0f /s\n", BOARD_BENCH_DEPTH, BOARD_BENCH_PAIRS / lineSec);
+    printf("  GameState copy per move:  %12.0f /s\n", BOARD_BENCH_COPIES / copySec);
+    printf("  board restored exactly: %s (checksum %ld)\n", isRestored ? "yes" : "NO", checksum);
+}
@@ -0,0 +1,135 @@
+#include "../include/frame.h"
+#include "../include/renderthread.h"
+#include "../include/simulation.h"
+#include <stdio.h>
+
+#define FRAME_DEFAULT_HZ 60
+#define FRAME_VSYNC_CHECK_FRAMES 120
+#define FRAME_IDLE_MS 250
+#define FRAME_IDLE_NETWORK_MS 10 // the network thread does not wake the game thread
+
+typedef struct {
+    Uint64 frames, busyTicks, wallTicks;
+} ScreenStats;
+
+static const char *screenNames[] = {
+    "splash", "mode menu", "opponent menu", "bot menu", "multiplayer menu",
+    "enter ip", "names", "tutorial", "waiting", "playing", "game over", "restart", "quit",
+    "mystery tutorial", "mystery", "mystery over"
+};
+
+static SDL_Window *window;
+static Uint64 frequency, periodTicks;
+static Uint64 workStartedAt, lastFinishedAt, nextDeadline;
+static bool isVsyncPaced = false;
+static Uint64 vsyncCheckStart, vsyncCheckFrames;
+static ScreenStats screenStats[STATE_MYSTERY_GAMEOVER + 1];
+
+void Frame_Init(AppContext *app) {
+    window = app->window;
+    frequency = SDL_GetPerformanceFrequency();
+    int hz = FRAME_DEFAULT_HZ;
+    SDL_DisplayMode mode;
+    if (window && SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window), &mode) == 0 && mode.refresh_rate > 0)
+        hz = mode.refresh_rate;
+    periodTicks = frequency / hz;
+
+    SDL_RendererInfo info;
+    isVsyncPaced = app->renderer && SDL_GetRendererInfo(app->renderer, &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+    workStartedAt = lastFinishedAt = vsyncCheckStart = SDL_GetPerformanceCounter();
+    nextDeadline = workStartedAt + periodTicks;
+    printf("Frame: %d Hz, paced by %s\n", hz, isVsyncPaced ? "vsync" : "sleeping");
+}
+
+bool Frame_IsWindowVisible(void) {
+    return !window || !(SDL_GetWindowFlags(window) & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN));
+}
+
+// Every menu and the board move on their own, so in practice this is a paused match or a
+// minimised window.
+bool Frame_IsIdle(const GameState *game) {
+    bool isPausedMatch = game->currentState == STATE_PLAYING && game->isPaused;
+    return !Frame_IsWindowVisible() || isPausedMatch;
+}
+
+// How long the game thread may block before it has to look at bots and the network again:
+// the next simulation tick while anything moves, otherwise until something is due.
+static int Frame_IdleTimeoutMs(const GameState *game) {
+    if (!Frame_IsIdle(game)) return Simulation_MsUntilNextTick(game);
+    if (game->isMultiplayer) return FRAME_IDLE_NETWORK_MS;
+    if (game->isSinglePlayer && game->currentState == STATE_PLAYING && game->currentPlayer == 1 && !game->isPaused) {
+        Uint32 waited = game->simTime - game->turnStartTime;
+        return waited >= SIM_BOT_THINK_MS ? 0 : (int)(SIM_BOT_THINK_MS - waited);
+    }
+    return FRAME_IDLE_MS;
+}
+
+bool Frame_WaitForEvent(const GameState *game, SDL_Event *event) {
+    int timeoutMs = Frame_IdleTimeoutMs(game);
+    return RenderThread_NextEvent(event, timeoutMs > 0 ? (Uint32)timeoutMs : 0);
+}
+
+void Frame_Begin(void) {
+    workStartedAt = SDL_GetPerformanceCounter();
+}
+
+static void Frame_SleepUntil(Uint64 deadline) {
+    for (;;) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        if (now >= deadline) return;
+        double remainingMs = (deadline - now) * 1000.0 / frequency;
+        // SDL_Delay can overshoot by a millisecond or so; the last stretch is yielded away instead.
+        SDL_Delay(remainingMs > 2.0 ? (Uint32)(remainingMs - 1.5) : 0);
+    }
+}
+
+// A driver can report vsync and still return from present straight away (some compositors,
+// occluded windows). If frames come back much faster than the refresh rate, pace by sleeping.
+static void Frame_CheckVsync(Uint64 now) {
+    if (++vsyncCheckFrames < FRAME_VSYNC_CHECK_FRAMES) return;
+    Uint64 averageTicks = (now - vsyncCheckStart) / vsyncCheckFrames;
+    vsyncCheckStart = now;
+    vsyncCheckFrames = 0;
+    if (averageTicks * 2 < periodTicks) {
+        isVsyncPaced = false;
+        nextDeadline = now + periodTicks;
+        printf("Frame: vsync is not holding frames (%.2f ms each), pacing by sleeping\n", averageTicks * 1000.0 / frequency);
+    }
+}
+
+void Frame_Finish(AppContext *app, GameStateEnum screen, bool didRender) {
+    Uint64 busyTicks = SDL_GetPerformanceCounter() - workStartedAt;
+    if (didRender) SDL_RenderPresent(app->renderer);
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (didRender && isVsyncPaced) {
+        Frame_CheckVsync(now);
+    } else if (didRender) {
+        if (now > nextDeadline + periodTicks) nextDeadline = now; // fell behind; do not try to catch up
+        Frame_SleepUntil(nextDeadline);
+        nextDeadline += periodTicks;
+        now = SDL_GetPerformanceCounter();
+    }
+
+    if ((int)screen >= 0 && screen <= STATE_MYSTERY_GAMEOVER) {
+        ScreenStats *stats = &screenStats[screen];
+        stats->frames += didRender;
+        stats->busyTicks += busyTicks;
+        stats->wallTicks += now - lastFinishedAt;
+    }
+    lastFinishedAt = now;
+}
+
+// Busy time is the render thread's own work per frame: drawing, but not waiting for a
+// snapshot, for vsync or in a sleep. Input, the simulation and the network run elsewhere.
+void Frame_Report(void) {
+    for (int screen = 0; screen <= STATE_MYSTERY_GAMEOVER; screen++) {
+        const ScreenStats *stats = &screenStats[screen];
+        if (stats->wallTicks == 0) continue;
+        double seconds = (double)stats->wallTicks / frequency;
+        printf("Frame: %-16s %7.1f s  %5.1f fps  %6.2f ms busy/frame  render thread %4.1f%% busy\n",
+               screenNames[screen], seconds, stats->frames / seconds,
+               stats->frames ? stats->busyTicks * 1000.0 / frequency / stats->frames : 0.0,
+               100.0 * stats->busyTicks / stats->wallTicks);
+    }
+}
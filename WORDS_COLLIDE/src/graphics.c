@@ -1,100 +1,471 @@
 #include "../include/graphics.h"
+#include "../include/audio.h"
 #include "../include/network.h"
+#include "../include/profiler.h"
+#include "../include/simulation.h"
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
 
+// Draw calls are counted for Graphics_GetFrameStats. Each wrapper expands to the real SDL
+// call of the same name, because a macro is never expanded inside its own replacement.
+static int frameDrawCalls = 0;
+#define SDL_RenderClear(renderer) (frameDrawCalls++, SDL_RenderClear(renderer))
+#define SDL_RenderCopy(renderer, texture, src, dst) (frameDrawCalls++, SDL_RenderCopy(renderer, texture, src, dst))
+#define SDL_RenderFillRect(renderer, rect) (frameDrawCalls++, SDL_RenderFillRect(renderer, rect))
+#define SDL_RenderDrawRect(renderer, rect) (frameDrawCalls++, SDL_RenderDrawRect(renderer, rect))
+#define SDL_RenderDrawLine(renderer, x1, y1, x2, y2) (frameDrawCalls++, SDL_RenderDrawLine(renderer, x1, y1, x2, y2))
+#define SDL_RenderGeometry(renderer, texture, vertices, vertexCount, indices, indexCount) \
+    (frameDrawCalls++, SDL_RenderGeometry(renderer, texture, vertices, vertexCount, indices, indexCount))
+
+// Cosmetic animations read this clock so the render benchmark can replay exact frames. Game
+// timers come from the simulation tick instead (see simulation.h).
+static bool isClockPinned = false;
+static Uint32 pinnedTicks = 0;
+
+static Uint32 Graphics_GetTicks(void)
+{
+    return isClockPinned ? pinnedTicks : SDL_GetTicks();
+}
+
+void Graphics_PinClock(bool isPinned, Uint32 ticks)
+{
+    isClockPinned = isPinned;
+    pinnedTicks = ticks;
+}
+
+// A timer value between the previous simulation tick and the latest one, drawn one tick behind
+// so it never runs ahead of what the simulation has decided. A pinned clock shows the latest.
+static Uint32 Graphics_Interpolate(const GameState *game, Uint32 previous, Uint32 latest)
+{
+    float alpha = 1.0f;
+    if (!isClockPinned && game->simTickAt != 0)
+        alpha = (float)(SDL_GetPerformanceCounter() - game->simTickAt) * 1000.0f / SDL_GetPerformanceFrequency() / SIM_TICK_MS;
+    if (alpha > 1.0f)
+        alpha = 1.0f;
+    return (Uint32)(previous + ((float)latest - (float)previous) * alpha);
+}
+
+// Printable ASCII for each font is rendered once into a single texture; a string is then
+// drawn as coloured quads from it, one SDL_RenderGeometry call per string.
+#define GLYPH_FIRST 32
+#define GLYPH_COUNT 95
+#define GLYPH_ATLAS_WIDTH 512
+#define GLYPH_ATLAS_MAX_FONTS 4
+#define GLYPH_BATCH_MAX 64
+
+typedef struct { SDL_Rect src; int offsetX, advance; } Glyph;
+typedef struct
+{
+    TTF_Font *font;
+    SDL_Texture *texture;
+    int width, height, lineHeight;
+    Glyph glyphs[GLYPH_COUNT];
+} GlyphAtlas;
+
+static GlyphAtlas glyphAtlases[GLYPH_ATLAS_MAX_FONTS];
+static int glyphAtlasCount = 0;
+// Each string drawn used to cost one surface and one texture upload; both are counted for the exit report.
+static int frameUploads = 0, frameTextDraws = 0, maxFrameUploads = 0, maxFrameTextDraws = 0;
+static GraphicsFrameStats lastFrame;
+static long totalUploads = 0, totalTextDraws = 0, frameCount = 0;
+
+static GlyphAtlas *Graphics_GetGlyphAtlas(AppContext *app, TTF_Font *font)
+{
+    for (int i = 0; i < glyphAtlasCount; i++)
+        if (glyphAtlases[i].font == font)
+            return glyphAtlases[i].texture ? &glyphAtlases[i] : NULL;
+    if (!font || glyphAtlasCount == GLYPH_ATLAS_MAX_FONTS)
+        return NULL;
+    GlyphAtlas *atlas = &glyphAtlases[glyphAtlasCount++];
+    memset(atlas, 0, sizeof(*atlas));
+    atlas->font = font;
+    atlas->lineHeight = TTF_FontHeight(font);
+
+    SDL_Surface *cells[GLYPH_COUNT];
+    int penX = 0, penY = 0;
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        Glyph *glyph = &atlas->glyphs[i];
+        char text[2] = {(char)(GLYPH_FIRST + i), '\0'};
+        int minX = 0, maxX = 0, minY = 0, maxY = 0;
+        TTF_GlyphMetrics(font, (Uint16)text[0], &minX, &maxX, &minY, &maxY, &glyph->advance);
+        glyph->offsetX = minX < 0 ? minX : 0;
+        cells[i] = TTF_RenderText_Blended(font, text, (SDL_Color){255, 255, 255, 255});
+        PROFILE_COUNT(PROFILE_TTF_RENDERS);
+        if (!cells[i])
+            continue;
+        if (penX + cells[i]->w > GLYPH_ATLAS_WIDTH)
+        {
+            penX = 0;
+            penY += atlas->lineHeight + 1;
+        }
+        glyph->src = (SDL_Rect){penX, penY, cells[i]->w, cells[i]->h};
+        penX += cells[i]->w + 1;
+    }
+    atlas->width = GLYPH_ATLAS_WIDTH;
+    atlas->height = penY + atlas->lineHeight + 1;
+
+    SDL_Surface *sheet = SDL_CreateRGBSurfaceWithFormat(0, atlas->width, atlas->height, 32, SDL_PIXELFORMAT_ARGB8888);
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        if (!cells[i])
+            continue;
+        if (sheet)
+        {
+            SDL_SetSurfaceBlendMode(cells[i], SDL_BLENDMODE_NONE);
+            SDL_BlitSurface(cells[i], NULL, sheet, &atlas->glyphs[i].src);
+        }
+        SDL_FreeSurface(cells[i]);
+    }
+    if (sheet)
+    {
+        atlas->texture = SDL_CreateTextureFromSurface(app->renderer, sheet);
+        PROFILE_COUNT(PROFILE_TEXTURE_CREATES);
+        SDL_FreeSurface(sheet);
+    }
+    if (!atlas->texture)
+        return NULL;
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    frameUploads++;
+    printf("Graphics: glyph atlas for %dpx font built, %dx%d\n", atlas->lineHeight, atlas->width, atlas->height);
+    return atlas;
+}
+
+static const Glyph *Graphics_GetGlyph(const GlyphAtlas *atlas, char c)
+{
+    unsigned char index = (unsigned char)c;
+    if (index < GLYPH_FIRST || index >= GLYPH_FIRST + GLYPH_COUNT)
+        index = '?';
+    return &atlas->glyphs[index - GLYPH_FIRST];
+}
+
+// Width from the cached advances, without kerning, so it matches how the quads are laid out.
+static void Graphics_MeasureText(AppContext *app, TTF_Font *fontToUse, const char *text, int *width, int *height)
+{
+    GlyphAtlas *atlas = Graphics_GetGlyphAtlas(app, fontToUse);
+    *width = *height = 0;
+    if (!atlas)
+        return;
+    for (const char *c = text; *c; c++)
+        *width += Graphics_GetGlyph(atlas, *c)->advance;
+    *height = atlas->lineHeight;
+}
+
+static void Graphics_AppendQuad(SDL_Vertex *vertices, int *indices, int quad, SDL_FRect rect, SDL_Color color, SDL_FRect uv)
+{
+    SDL_Vertex *corner = &vertices[quad * 4];
+    corner[0] = (SDL_Vertex){{rect.x, rect.y}, color, {uv.x, uv.y}};
+    corner[1] = (SDL_Vertex){{rect.x + rect.w, rect.y}, color, {uv.x + uv.w, uv.y}};
+    corner[2] = (SDL_Vertex){{rect.x + rect.w, rect.y + rect.h}, color, {uv.x + uv.w, uv.y + uv.h}};
+    corner[3] = (SDL_Vertex){{rect.x, rect.y + rect.h}, color, {uv.x, uv.y + uv.h}};
+    if (!indices)
+        return; // the caller keeps a prebuilt index buffer
+    int *index = &indices[quad * 6];
+    int base = quad * 4;
+    index[0] = base; index[1] = base + 1; index[2] = base + 2;
+    index[3] = base; index[4] = base + 2; index[5] = base + 3;
+}
+
+// Adds the glyph's quad if it has one (spaces do not). Returns the number of quads added.
+static int Graphics_AppendGlyph(const GlyphAtlas *atlas, const Glyph *glyph, SDL_Vertex *vertices, int *indices, int quad, int x, int y, SDL_Color color)
+{
+    if (glyph->src.w <= 0)
+        return 0;
+    SDL_FRect rect = {(float)(x + glyph->offsetX), (float)y, (float)glyph->src.w, (float)glyph->src.h};
+    SDL_FRect uv = {(float)glyph->src.x / atlas->width, (float)glyph->src.y / atlas->height,
+                    (float)glyph->src.w / atlas->width, (float)glyph->src.h / atlas->height};
+    Graphics_AppendQuad(vertices, indices, quad, rect, color, uv);
+    return 1;
+}
+
 static void Graphics_DrawText(AppContext *app, TTF_Font *fontToUse, const char *text, int x, int y, SDL_Color color)
 {
-    SDL_Surface *surface = TTF_RenderText_Solid(fontToUse, text, color);
-    if (surface)
+    GlyphAtlas *atlas = Graphics_GetGlyphAtlas(app, fontToUse);
+    if (!atlas)
+        return;
+    frameTextDraws++;
+    SDL_Vertex vertices[GLYPH_BATCH_MAX * 4];
+    int indices[GLYPH_BATCH_MAX * 6];
+    int quads = 0;
+    for (const char *c = text; *c; c++)
     {
-        SDL_Texture *texture = SDL_CreateTextureFromSurface(app->renderer, surface);
-        SDL_Rect rect = {x, y, surface->w, surface->h};
-        SDL_RenderCopy(app->renderer, texture, NULL, &rect);
-        SDL_DestroyTexture(texture);
-        SDL_FreeSurface(surface);
+        const Glyph *glyph = Graphics_GetGlyph(atlas, *c);
+        quads += Graphics_AppendGlyph(atlas, glyph, vertices, indices, quads, x, y, color);
+        if (quads == GLYPH_BATCH_MAX)
+        {
+            SDL_RenderGeometry(app->renderer, atlas->texture, vertices, quads * 4, indices, quads * 6);
+            quads = 0;
+        }
+        x += glyph->advance;
     }
+    if (quads > 0)
+        SDL_RenderGeometry(app->renderer, atlas->texture, vertices, quads * 4, indices, quads * 6);
 }
 static void Graphics_DrawTextCentered(AppContext *app, TTF_Font *fontToUse, const char *text, int y, SDL_Color color)
 {
     int textWidth = 0, textHeight = 0;
-    TTF_SizeText(fontToUse, text, &textWidth, &textHeight);
+    Graphics_MeasureText(app, fontToUse, text, &textWidth, &textHeight);
     int x = (WINDOW_WIDTH - textWidth) / 2;
     Graphics_DrawText(app, fontToUse, text, x, y, color);
 }
+
+void Graphics_EndFrame(void)
+{
+    if (frameUploads > maxFrameUploads)
+        maxFrameUploads = frameUploads;
+    if (frameTextDraws > maxFrameTextDraws)
+        maxFrameTextDraws = frameTextDraws;
+    totalUploads += frameUploads;
+    totalTextDraws += frameTextDraws;
+    frameCount++;
+    lastFrame = (GraphicsFrameStats){frameDrawCalls, frameUploads, frameTextDraws};
+    frameUploads = frameTextDraws = frameDrawCalls = 0;
+}
+
+void Graphics_GetFrameStats(GraphicsFrameStats *stats)
+{
+    *stats = lastFrame;
+}
+
+void Graphics_Cleanup(void)
+{
+    if (frameCount > 0)
+        printf("Graphics: %ld frames, %.2f texture uploads/frame (max %d), %.1f text draws/frame (max %d) that each used to upload one\n",
+               frameCount, (double)totalUploads / frameCount, maxFrameUploads, (double)totalTextDraws / frameCount, maxFrameTextDraws);
+    Graphics_ResetRenderTargets();
+    for (int i = 0; i < glyphAtlasCount; i++)
+        if (glyphAtlases[i].texture)
+            SDL_DestroyTexture(glyphAtlases[i].texture);
+    glyphAtlasCount = 0;
+}
+// Menu backgrounds are particle fields kept as structure-of-arrays, so the per-frame update
+// is a few straight loops over floats and the whole field is one SDL_RenderGeometry call.
+#define PARTICLE_MAX 4096
+#define SINE_TABLE_SIZE 1024
+#define TWO_PI 6.28318530718
+
+typedef struct
+{
+    int count;
+    char firstGlyph;
+    int glyphCycle;
+    SDL_Color color;
+    float strideX, strideY, msPerPixel, msPerRadian, waveHeight, margin;
+    float startX[PARTICLE_MAX], startY[PARTICLE_MAX], phase[PARTICLE_MAX];
+    float x[PARTICLE_MAX], y[PARTICLE_MAX];
+    const Glyph *glyph[PARTICLE_MAX];
+} ParticleField;
+
+static float sineTable[SINE_TABLE_SIZE];
+static SDL_Vertex particleVertices[PARTICLE_MAX * 4];
+static int particleIndices[PARTICLE_MAX * 6];
+static bool areParticleTablesReady = false;
+
+static ParticleField letterField = {.count = 30, .firstGlyph = 'A', .glyphCycle = 26, .color = {220, 200, 245, 255},
+                                    .strideX = 87, .strideY = 113, .msPerPixel = 40, .msPerRadian = 800, .waveHeight = 80, .margin = 25};
+static ParticleField mysteryField = {.count = 25, .firstGlyph = '?', .glyphCycle = 1, .color = {50, 50, 90, 50},
+                                     .strideX = 133, .strideY = 157, .msPerPixel = 70, .msPerRadian = 1500, .waveHeight = 50, .margin = 40};
+
+static void Graphics_InitParticleField(ParticleField *field, const GlyphAtlas *atlas)
+{
+    if (!areParticleTablesReady)
+    {
+        for (int i = 0; i < SINE_TABLE_SIZE; i++)
+            sineTable[i] = (float)sin(i * TWO_PI / SINE_TABLE_SIZE);
+        // Every quad uses the same two triangles, so the indices never change.
+        for (int i = 0; i < PARTICLE_MAX; i++)
+        {
+            int *index = &particleIndices[i * 6];
+            index[0] = i * 4; index[1] = i * 4 + 1; index[2] = i * 4 + 2;
+            index[3] = i * 4; index[4] = i * 4 + 2; index[5] = i * 4 + 3;
+        }
+        areParticleTablesReady = true;
+    }
+    if (field->count > PARTICLE_MAX)
+        field->count = PARTICLE_MAX;
+    for (int i = 0; i < field->count; i++)
+    {
+        field->startX[i] = i * field->strideX;
+        field->startY[i] = i * field->strideY;
+        field->phase[i] = (float)i;
+        field->glyph[i] = Graphics_GetGlyph(atlas, (char)(field->firstGlyph + i % field->glyphCycle));
+    }
+}
+
+static void Graphics_DrawParticleField(AppContext *app, ParticleField *field)
+{
+    GlyphAtlas *atlas = Graphics_GetGlyphAtlas(app, app->fontLarge);
+    if (!atlas)
+        return;
+    if (!field->glyph[0])
+        Graphics_InitParticleField(field, atlas);
+
+    int count = field->count;
+    Uint32 time = Graphics_GetTicks();
+    float spanX = WINDOW_WIDTH + 2 * field->margin, spanY = WINDOW_HEIGHT + 2 * field->margin;
+    // Divided in double: a float quotient of a large tick count has lost whole pixels.
+    float drift = (float)fmod(time / (double)field->msPerPixel, spanX);
+    float wave = (float)fmod(time / (double)field->msPerRadian, TWO_PI);
+    const float toTable = SINE_TABLE_SIZE / (float)TWO_PI;
+    for (int i = 0; i < count; i++)
+    {
+        int slot = (int)((wave + field->phase[i]) * toTable) & (SINE_TABLE_SIZE - 1);
+        field->x[i] = field->startX[i] + drift;
+        field->y[i] = field->startY[i] + field->waveHeight * sineTable[slot];
+    }
+    for (int i = 0; i < count; i++)
+    {
+        field->x[i] -= spanX * floorf(field->x[i] / spanX) + field->margin;
+        field->y[i] -= spanY * floorf(field->y[i] / spanY) + field->margin;
+    }
+
+    int quads = 0;
+    for (int i = 0; i < count; i++)
+        quads += Graphics_AppendGlyph(atlas, field->glyph[i], particleVertices, NULL, quads, (int)field->x[i], (int)field->y[i], field->color);
+    if (quads > 0)
+        SDL_RenderGeometry(app->renderer, atlas->texture, particleVertices, quads * 4, particleIndices, quads * 6);
+}
+
 static void Graphics_DrawAnimatedBackground(AppContext *app)
 {
     SDL_SetRenderDrawColor(app->renderer, 240, 230, 255, 255);
     SDL_RenderClear(app->renderer);
-    Uint32 time = SDL_GetTicks();
-    SDL_Color faintColor = {220, 200, 245, 255};
-    for (int i = 0; i < 30; i++)
-    {
-        char letter[2] = {'A' + (i % 26), '\0'};
-        int x = (int)((i * 87) + (time / 40.0)) % (WINDOW_WIDTH + 50) - 25;
-        int y = (int)((i * 113) + sin(time / 800.0 + i) * 80) % (WINDOW_HEIGHT + 50) - 25;
-        Graphics_DrawText(app, app->fontLarge, letter, x, y, faintColor);
-    }
+    Graphics_DrawParticleField(app, &letterField);
 }
 static void Graphics_DrawMysteryBackground(AppContext *app)
 {
     SDL_SetRenderDrawColor(app->renderer, 15, 10, 35, 255);
     SDL_RenderClear(app->renderer);
-    Uint32 time = SDL_GetTicks();
-    SDL_Color faintColor = {50, 50, 90, 50};
-    for (int i = 0; i < 25; i++)
-    {
-        char symbol[2] = "?";
-        int x = (int)((i * 133) + (time / 70.0)) % (WINDOW_WIDTH + 80) - 40;
-        int y = (int)((i * 157) + sin(time / 1500.0 + i) * 50) % (WINDOW_HEIGHT + 80) - 40;
-        Graphics_DrawText(app, app->fontLarge, symbol, x, y, faintColor);
-    }
+    Graphics_DrawParticleField(app, &mysteryField);
 }
-static void Graphics_DrawButton(AppContext *app, Button *button)
+// Retained button layers: each button's look in each state is rendered once into a target
+// texture, and a frame only copies the layer in. Layers are keyed by look (label and size), not
+// by Button, so a button shares its layer across render snapshots and with lookalike buttons.
+#define BUTTON_LAYER_MAX 24
+#define BUTTON_SHADOW_X 3
+#define BUTTON_SHADOW_Y 5
+
+typedef struct
+{
+    char text[64];
+    int w, h;
+    SDL_Texture *states[2]; // normal, hovered
+} ButtonLayer;
+
+static ButtonLayer buttonLayers[BUTTON_LAYER_MAX];
+static int buttonLayerCount = 0;
+
+// Draws the button with its top-left corner at (x, y); the shadow extends right and down.
+static void Graphics_PaintButton(AppContext *app, const Button *button, bool isHovered, int x, int y)
 {
     SDL_Color shadowColor = {80, 40, 120, 255};
     SDL_Color btnColor = {110, 60, 160, 255};
     SDL_Color hoverColor = {140, 90, 190, 255};
     SDL_Color textColor = {255, 255, 255, 255};
-    int yOffset = button->isHovered ? 3 : 0;
-    SDL_Rect shadowRect = {button->rect.x + 3, button->rect.y + 5, button->rect.w, button->rect.h};
+    int yOffset = isHovered ? 3 : 0;
+    SDL_Rect shadowRect = {x + BUTTON_SHADOW_X, y + BUTTON_SHADOW_Y, button->rect.w, button->rect.h};
     SDL_SetRenderDrawColor(app->renderer, shadowColor.r, shadowColor.g, shadowColor.b, shadowColor.a);
     SDL_RenderFillRect(app->renderer, &shadowRect);
-    SDL_Rect visualRect = {button->rect.x, button->rect.y + yOffset, button->rect.w, button->rect.h};
-    if (button->isHovered)
+    SDL_Rect visualRect = {x, y + yOffset, button->rect.w, button->rect.h};
+    if (isHovered)
         SDL_SetRenderDrawColor(app->renderer, hoverColor.r, hoverColor.g, hoverColor.b, hoverColor.a);
     else
         SDL_SetRenderDrawColor(app->renderer, btnColor.r, btnColor.g, btnColor.b, btnColor.a);
     SDL_RenderFillRect(app->renderer, &visualRect);
     int textWidth = 0, textHeight = 0;
-    TTF_SizeText(app->fontRegular, button->text, &textWidth, &textHeight);
+    Graphics_MeasureText(app, app->fontRegular, button->text, &textWidth, &textHeight);
     int textX = visualRect.x + (visualRect.w - textWidth) / 2;
     int textY = visualRect.y + (visualRect.h - textHeight) / 2;
     Graphics_DrawText(app, app->fontRegular, button->text, textX, textY, textColor);
 }
 
-void Graphics_RenderSplashScreen(AppContext *app, GameState *game)
+static void Graphics_FreeButtonLayer(ButtonLayer *layer)
+{
+    for (int state = 0; state < 2; state++)
+    {
+        if (layer->states[state])
+            SDL_DestroyTexture(layer->states[state]);
+        layer->states[state] = NULL;
+    }
+}
+
+static ButtonLayer *Graphics_GetButtonLayer(const Button *button)
+{
+    for (int i = 0; i < buttonLayerCount; i++)
+    {
+        ButtonLayer *layer = &buttonLayers[i];
+        if (layer->w == button->rect.w && layer->h == button->rect.h && strcmp(layer->text, button->text) == 0)
+            return layer;
+    }
+    if (buttonLayerCount == BUTTON_LAYER_MAX || strlen(button->text) >= sizeof(buttonLayers[0].text))
+        return NULL;
+    ButtonLayer *layer = &buttonLayers[buttonLayerCount++];
+    memset(layer, 0, sizeof(*layer));
+    layer->w = button->rect.w;
+    layer->h = button->rect.h;
+    strcpy(layer->text, button->text);
+    return layer;
+}
+
+static SDL_Texture *Graphics_RenderButtonLayer(AppContext *app, ButtonLayer *layer, const Button *button, bool isHovered)
+{
+    SDL_Texture **texture = &layer->states[isHovered];
+    if (*texture)
+        return *texture;
+
+    *texture = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                 button->rect.w + BUTTON_SHADOW_X, button->rect.h + BUTTON_SHADOW_Y);
+    PROFILE_COUNT(PROFILE_TEXTURE_CREATES);
+    if (!*texture)
+        return NULL;
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(app->renderer);
+    SDL_SetRenderTarget(app->renderer, *texture);
+    SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(app->renderer);
+    Graphics_PaintButton(app, button, isHovered, 0, 0);
+    SDL_SetRenderTarget(app->renderer, previousTarget);
+    SDL_SetTextureBlendMode(*texture, SDL_BLENDMODE_BLEND);
+    frameUploads++;
+    return *texture;
+}
+
+static void Graphics_DrawButton(AppContext *app, const Button *button)
+{
+    // No layers before the font has landed, or they would keep their blank labels.
+    ButtonLayer *layer = app->fontRegular && SDL_RenderTargetSupported(app->renderer) ? Graphics_GetButtonLayer(button) : NULL;
+    SDL_Texture *texture = layer ? Graphics_RenderButtonLayer(app, layer, button, button->isHovered) : NULL;
+    if (!texture)
+    {
+        Graphics_PaintButton(app, button, button->isHovered, button->rect.x, button->rect.y);
+        return;
+    }
+    SDL_Rect dest = {button->rect.x, button->rect.y, button->rect.w + BUTTON_SHADOW_X, button->rect.h + BUTTON_SHADOW_Y};
+    SDL_RenderCopy(app->renderer, texture, NULL, &dest);
+}
+
+void Graphics_RenderSplashScreen(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     Graphics_DrawTextCentered(app, app->fontLarge, "SELECT GAME", 120 + titleBob, (SDL_Color){90, 30, 140, 255});
     Graphics_DrawButton(app, &game->playWordsCollideButton);
     Graphics_DrawButton(app, &game->playMysteryButton);
+    Graphics_DrawButton(app, &game->playMysteryHardButton);
 }
-void Graphics_RenderModeMenu(AppContext *app, GameState *game)
+void Graphics_RenderModeMenu(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     Graphics_DrawTextCentered(app, app->fontLarge, "Words Collide: Mode", 120 + titleBob, (SDL_Color){90, 30, 140, 255});
     Graphics_DrawButton(app, &game->classicModeButton);
     Graphics_DrawButton(app, &game->blitzModeButton);
     Graphics_DrawButton(app, &game->backButton);
 }
-void Graphics_RenderOpponentMenu(AppContext *app, GameState *game)
+void Graphics_RenderOpponentMenu(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     const char *modeText = (game->gameMode == 0) ? "Classic Mode" : "Blitz Mode";
     Graphics_DrawTextCentered(app, app->fontLarge, modeText, 120 + titleBob, (SDL_Color){90, 30, 140, 255});
     Graphics_DrawTextCentered(app, app->fontRegular, "Select Opponent Type", 200 + titleBob, (SDL_Color){60, 60, 60, 255});
@@ -103,46 +474,58 @@ void Graphics_RenderOpponentMenu(AppContext *app, GameState *game)
     Graphics_DrawButton(app, &game->multiplayerButton);
     Graphics_DrawButton(app, &game->backButton);
 }
-void Graphics_RenderBotMenu(AppContext *app, GameState *game)
+void Graphics_RenderBotMenu(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     Graphics_DrawTextCentered(app, app->fontLarge, "Select Bot Difficulty", 120 + titleBob, (SDL_Color){90, 30, 140, 255});
     Graphics_DrawButton(app, &game->botEasyButton);
     Graphics_DrawButton(app, &game->botHardButton);
     Graphics_DrawButton(app, &game->backButton);
 }
-void Graphics_RenderMultiplayerMenu(AppContext *app, GameState *game)
+void Graphics_RenderMultiplayerMenu(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     Graphics_DrawTextCentered(app, app->fontLarge, "Multiplayer Setup", 120 + titleBob, (SDL_Color){90, 30, 140, 255});
     Graphics_DrawTextCentered(app, app->fontRegular, "Make sure both devices are on the same Wi-Fi!", 220 + titleBob, (SDL_Color){60, 60, 60, 255});
     Graphics_DrawButton(app, &game->hostGameButton);
     Graphics_DrawButton(app, &game->joinGameButton);
     Graphics_DrawButton(app, &game->backButton);
 }
-void Graphics_RenderIPInput(AppContext *app, GameState *game)
+void Graphics_RenderIPInput(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     Graphics_DrawTextCentered(app, app->fontLarge, "Join Game", 120 + titleBob, (SDL_Color){90, 30, 140, 255});
-    SDL_Rect input_box_rect = {100, 300, WINDOW_WIDTH - 200, 50};
+    SDL_Rect input_box_rect = {100, 190, WINDOW_WIDTH - 200, 50};
     SDL_SetRenderDrawColor(app->renderer, 255, 255, 255, 255);
     SDL_RenderFillRect(app->renderer, &input_box_rect);
     int textWidth = 0, textHeight = 0;
     if (strlen(game->targetIP) > 0)
     {
-        TTF_SizeText(app->fontRegular, game->targetIP, &textWidth, &textHeight);
+        Graphics_MeasureText(app, app->fontRegular, game->targetIP, &textWidth, &textHeight);
         Graphics_DrawText(app, app->fontRegular, game->targetIP, input_box_rect.x + 15, input_box_rect.y + 12, (SDL_Color){0, 0, 0, 255});
     }
-    Graphics_DrawTextCentered(app, app->fontRegular, "Press ENTER to Connect", 400, (SDL_Color){50, 50, 50, 255});
+    Graphics_DrawTextCentered(app, app->fontRegular, "Type an IP and press ENTER, or pick a game below", 260, (SDL_Color){50, 50, 50, 255});
+
+    DiscoveredHost hosts[HOST_LIST_ROWS];
+    int hostCount = Network_GetDiscoveredHosts(hosts, HOST_LIST_ROWS);
+    if (hostCount == 0)
+        Graphics_DrawTextCentered(app, app->fontRegular, "Searching your network...", HOST_LIST_Y + 5, (SDL_Color){100, 100, 100, 255});
+    for (int i = 0; i < hostCount; i++)
+    {
+        SDL_Rect row = {100, HOST_LIST_Y + i * HOST_LIST_ROW_HEIGHT, WINDOW_WIDTH - 200, HOST_LIST_ROW_HEIGHT - 5};
+        SDL_SetRenderDrawColor(app->renderer, 235, 225, 250, 255);
+        SDL_RenderFillRect(app->renderer, &row);
+        Graphics_DrawText(app, app->fontRegular, hosts[i].label, row.x + 15, row.y + 5, (SDL_Color){90, 30, 140, 255});
+    }
     Graphics_DrawButton(app, &game->backButton);
 }
-void Graphics_RenderNameInput(AppContext *app, GameState *game)
+void Graphics_RenderNameInput(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     Graphics_DrawTextCentered(app, app->fontLarge, "Enter Player Names", 120 + titleBob, (SDL_Color){90, 30, 140, 255});
     char prompt[50];
     sprintf(prompt, "Enter Player %d Name:", game->currentNameInput + 1);
@@ -154,12 +537,12 @@ void Graphics_RenderNameInput(AppContext *app, GameState *game)
     int textWidth = 0, textHeight = 0;
     if (strlen(currentName) > 0)
     {
-        TTF_SizeText(app->fontRegular, currentName, &textWidth, &textHeight);
+        Graphics_MeasureText(app, app->fontRegular, currentName, &textWidth, &textHeight);
         Graphics_DrawText(app, app->fontRegular, currentName, input_box_rect.x + 15, input_box_rect.y + 12, (SDL_Color){0, 0, 0, 255});
     }
     Graphics_DrawTextCentered(app, app->fontRegular, "Press ENTER to confirm", 400, (SDL_Color){50, 50, 50, 255});
 }
-void Graphics_RenderTutorial(AppContext *app, GameState *game)
+void Graphics_RenderTutorial(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
     Graphics_DrawTextCentered(app, app->fontLarge, "HOW TO PLAY", 150, (SDL_Color){90, 30, 140, 255});
@@ -176,7 +559,7 @@ void Graphics_RenderTutorial(AppContext *app, GameState *game)
         Graphics_DrawTextCentered(app, app->fontRegular, "You only have 7 seconds per turn.", 330, textColor);
         Graphics_DrawTextCentered(app, app->fontRegular, "If you don't play fast, you lose your turn!", 370, textColor);
     }
-    int timeLeft = 6 - ((SDL_GetTicks() - game->tutorialStartTime) / 1000);
+    int timeLeft = 6 - ((game->simTime - game->tutorialStartTime) / 1000);
     if (timeLeft < 1)
         timeLeft = 1;
     char timeText[100];
@@ -185,14 +568,21 @@ void Graphics_RenderTutorial(AppContext *app, GameState *game)
     Graphics_DrawTextCentered(app, app->fontRegular, "(Click or Press Any Key to Skip)", 600, (SDL_Color){100, 100, 100, 255});
 }
 
-void Graphics_RenderGame(AppContext *app, GameState *game)
-{
-    SDL_SetRenderDrawColor(app->renderer, 230, 220, 245, 255);
-    SDL_RenderClear(app->renderer);
+// The board lives in a target texture: grid lines are drawn into it once, and a tile is
+// painted only when its cell changes. Highlighted tiles and the selection go on top every
+// frame as one batch of quads plus one batch of letters, so draw calls do not grow with the board.
+#define BOARD_WIDTH (GRID_COLS * TILE_SIZE + 1)
+#define BOARD_HEIGHT (GRID_ROWS * TILE_SIZE + 1)
+#define BOARD_QUADS_MAX (GRID_COLS * GRID_ROWS * 2 + 4)
+#define BOARD_LETTERS_MAX (GRID_COLS * GRID_ROWS + 1)
 
-    int startX = (WINDOW_WIDTH - (GRID_COLS * TILE_SIZE)) / 2;
-    int startY = 45 + (WINDOW_HEIGHT - 60 - 45 - (GRID_ROWS * TILE_SIZE)) / 2;
+static SDL_Texture *boardTexture = NULL;
+static char boardCells[GRID_COLS][GRID_ROWS]; // letters already painted into boardTexture
+static SDL_Vertex tileVertices[BOARD_QUADS_MAX * 4], letterVertices[BOARD_LETTERS_MAX * 4];
+static int tileIndices[BOARD_QUADS_MAX * 6], letterIndices[BOARD_LETTERS_MAX * 6];
 
+static void Graphics_DrawGridLines(AppContext *app, int startX, int startY)
+{
     SDL_SetRenderDrawColor(app->renderer, 200, 180, 220, 255);
     for (int i = 0; i <= GRID_COLS; i++)
     {
@@ -202,53 +592,158 @@ void Graphics_RenderGame(AppContext *app, GameState *game)
     {
         SDL_RenderDrawLine(app->renderer, startX, startY + i * TILE_SIZE, startX + GRID_COLS * TILE_SIZE, startY + i * TILE_SIZE);
     }
+}
+
+static void Graphics_AppendTile(int *quads, int px, int py, SDL_Color face)
+{
+    SDL_FRect noTexture = {0, 0, 0, 0};
+    SDL_FRect shadow = {(float)(px + 3), (float)(py + 3), TILE_SIZE - 4, TILE_SIZE - 4};
+    SDL_FRect tileBase = {(float)(px + 1), (float)(py + 1), TILE_SIZE - 4, TILE_SIZE - 4};
+    Graphics_AppendQuad(tileVertices, tileIndices, (*quads)++, shadow, (SDL_Color){130, 110, 150, 255}, noTexture);
+    Graphics_AppendQuad(tileVertices, tileIndices, (*quads)++, tileBase, face, noTexture);
+}
+
+static void Graphics_AppendTileLetter(const GlyphAtlas *atlas, int *quads, int px, int py, char letter, SDL_Color color)
+{
+    if (!atlas)
+        return;
+    const Glyph *glyph = Graphics_GetGlyph(atlas, letter);
+    int ltw = glyph->advance ? glyph->advance : 14;
+    int lth = atlas->lineHeight ? atlas->lineHeight : 24;
+    *quads += Graphics_AppendGlyph(atlas, glyph, letterVertices, letterIndices, *quads, px + (TILE_SIZE - ltw) / 2, py + (TILE_SIZE - lth) / 2, color);
+}
+
+static void Graphics_FlushBoardBatches(AppContext *app, const GlyphAtlas *atlas, int tileQuads, int letterQuads)
+{
+    if (tileQuads > 0)
+        SDL_RenderGeometry(app->renderer, NULL, tileVertices, tileQuads * 4, tileIndices, tileQuads * 6);
+    if (letterQuads > 0)
+        SDL_RenderGeometry(app->renderer, atlas->texture, letterVertices, letterQuads * 4, letterIndices, letterQuads * 6);
+}
+
+// Brings the board texture up to date with the grid. Returns false if the renderer cannot
+// keep one, or the font has not landed yet (cached tiles would keep blank letters), in which
+// case the caller draws the whole board directly.
+static bool Graphics_UpdateBoardLayer(AppContext *app, const GameState *game, const GlyphAtlas *atlas)
+{
+    if (!atlas)
+        return false;
+    if (!boardTexture)
+    {
+        if (!SDL_RenderTargetSupported(app->renderer))
+            return false;
+        boardTexture = SDL_CreateTexture(app->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, BOARD_WIDTH, BOARD_HEIGHT);
+        PROFILE_COUNT(PROFILE_TEXTURE_CREATES);
+        if (!boardTexture)
+            return false;
+        SDL_Texture *previousTarget = SDL_GetRenderTarget(app->renderer);
+        SDL_SetRenderTarget(app->renderer, boardTexture);
+        SDL_SetRenderDrawColor(app->renderer, 230, 220, 245, 255);
+        SDL_RenderClear(app->renderer);
+        Graphics_DrawGridLines(app, 0, 0);
+        SDL_SetRenderTarget(app->renderer, previousTarget);
+        memset(boardCells, 0, sizeof(boardCells));
+        frameUploads++;
+    }
 
+    int tileQuads = 0, letterQuads = 0;
+    SDL_FRect noTexture = {0, 0, 0, 0};
     for (int x = 0; x < GRID_COLS; x++)
     {
         for (int y = 0; y < GRID_ROWS; y++)
         {
+            if (game->grid[x][y] == boardCells[x][y])
+                continue;
+            int px = x * TILE_SIZE, py = y * TILE_SIZE;
             if (game->grid[x][y])
             {
-                int px = startX + x * TILE_SIZE;
-                int py = startY + y * TILE_SIZE;
-                SDL_SetRenderDrawColor(app->renderer, 130, 110, 150, 255);
-                SDL_Rect shadow = {px + 3, py + 3, TILE_SIZE - 4, TILE_SIZE - 4};
-                SDL_RenderFillRect(app->renderer, &shadow);
-                if (SDL_GetTicks() < game->highlightEndTime[x][y])
-                    SDL_SetRenderDrawColor(app->renderer, 255, 204, 51, 255);
-                else
-                    SDL_SetRenderDrawColor(app->renderer, 255, 250, 240, 255);
-                SDL_Rect tileBase = {px + 1, py + 1, TILE_SIZE - 4, TILE_SIZE - 4};
-                SDL_RenderFillRect(app->renderer, &tileBase);
-                char letter[2] = {game->grid[x][y], '\0'};
-                int ltw = 0, lth = 0;
-                TTF_SizeText(app->fontRegular, letter, &ltw, &lth);
-                if (ltw == 0)
-                    ltw = 14;
-                if (lth == 0)
-                    lth = 24;
-                Graphics_DrawText(app, app->fontRegular, letter, px + (TILE_SIZE - ltw) / 2, py + (TILE_SIZE - lth) / 2, (SDL_Color){0, 0, 0, 255});
+                Graphics_AppendTile(&tileQuads, px, py, (SDL_Color){255, 250, 240, 255});
+                Graphics_AppendTileLetter(atlas, &letterQuads, px, py, game->grid[x][y], (SDL_Color){0, 0, 0, 255});
             }
+            else
+            {
+                // Everything inside the cell's grid lines goes back to the board colour.
+                SDL_FRect cell = {(float)(px + 1), (float)(py + 1), TILE_SIZE - 1, TILE_SIZE - 1};
+                Graphics_AppendQuad(tileVertices, tileIndices, tileQuads++, cell, (SDL_Color){230, 220, 245, 255}, noTexture);
+            }
+            boardCells[x][y] = game->grid[x][y];
         }
     }
+    if (tileQuads == 0)
+        return true;
+    SDL_Texture *previousTarget = SDL_GetRenderTarget(app->renderer);
+    SDL_SetRenderTarget(app->renderer, boardTexture);
+    Graphics_FlushBoardBatches(app, atlas, tileQuads, letterQuads);
+    SDL_SetRenderTarget(app->renderer, previousTarget);
+    frameUploads++;
+    return true;
+}
 
-    if (game->isTileSelected)
+void Graphics_ResetRenderTargets(void)
+{
+    for (int i = 0; i < buttonLayerCount; i++)
+        Graphics_FreeButtonLayer(&buttonLayers[i]);
+    buttonLayerCount = 0;
+    if (boardTexture)
+        SDL_DestroyTexture(boardTexture);
+    boardTexture = NULL;
+}
+
+void Graphics_RenderGame(AppContext *app, const GameState *game)
+{
+    SDL_SetRenderDrawColor(app->renderer, 230, 220, 245, 255);
+    SDL_RenderClear(app->renderer);
+
+    int startX = (WINDOW_WIDTH - (GRID_COLS * TILE_SIZE)) / 2;
+    int startY = 45 + (WINDOW_HEIGHT - 60 - 45 - (GRID_ROWS * TILE_SIZE)) / 2;
+
+    GlyphAtlas *atlas = Graphics_GetGlyphAtlas(app, app->fontRegular);
+    bool hasBoardLayer = Graphics_UpdateBoardLayer(app, game, atlas);
+    if (hasBoardLayer)
+    {
+        SDL_Rect boardRect = {startX, startY, BOARD_WIDTH, BOARD_HEIGHT};
+        SDL_RenderCopy(app->renderer, boardTexture, NULL, &boardRect);
+    }
+    else
     {
-        SDL_SetRenderDrawColor(app->renderer, 255, 0, 0, 255);
-        SDL_Rect sRect = {startX + game->selectedX * TILE_SIZE, startY + game->selectedY * TILE_SIZE, TILE_SIZE, TILE_SIZE};
-        for (int b = 0; b < 4; b++)
+        Graphics_DrawGridLines(app, startX, startY);
+    }
+
+    int tileQuads = 0, letterQuads = 0;
+    for (int x = 0; x < GRID_COLS; x++)
+    {
+        for (int y = 0; y < GRID_ROWS; y++)
         {
-            SDL_Rect thickRect = {sRect.x + b, sRect.y + b, sRect.w - (b * 2), sRect.h - (b * 2)};
-            SDL_RenderDrawRect(app->renderer, &thickRect);
+            if (!game->grid[x][y])
+                continue;
+            bool isHighlighted = game->highlightEndTime[x][y] != 0; // cleared by the simulation tick
+            if (hasBoardLayer && !isHighlighted)
+                continue;
+            int px = startX + x * TILE_SIZE;
+            int py = startY + y * TILE_SIZE;
+            SDL_Color face = isHighlighted ? (SDL_Color){255, 204, 51, 255} : (SDL_Color){255, 250, 240, 255};
+            Graphics_AppendTile(&tileQuads, px, py, face);
+            Graphics_AppendTileLetter(atlas, &letterQuads, px, py, game->grid[x][y], (SDL_Color){0, 0, 0, 255});
         }
+    }
+
+    if (game->isTileSelected)
+    {
+        SDL_Color red = {255, 0, 0, 255};
+        SDL_FRect noTexture = {0, 0, 0, 0};
+        float sx = (float)(startX + game->selectedX * TILE_SIZE), sy = (float)(startY + game->selectedY * TILE_SIZE);
+        SDL_FRect frame[4] = {
+            {sx, sy, TILE_SIZE, 4},
+            {sx, sy + TILE_SIZE - 4, TILE_SIZE, 4},
+            {sx, sy + 4, 4, TILE_SIZE - 8},
+            {sx + TILE_SIZE - 4, sy + 4, 4, TILE_SIZE - 8},
+        };
+        for (int side = 0; side < 4; side++)
+            Graphics_AppendQuad(tileVertices, tileIndices, tileQuads++, frame[side], red, noTexture);
         if (game->currentLetter)
-        {
-            char letter[2] = {game->currentLetter, '\0'};
-            int ltw = 0, lth = 0;
-            TTF_SizeText(app->fontRegular, letter, &ltw, &lth);
-            Graphics_DrawText(app, app->fontRegular, letter, sRect.x + (TILE_SIZE - ltw) / 2, sRect.y + (TILE_SIZE - lth) / 2, (SDL_Color){255, 0, 0, 255});
-        }
+            Graphics_AppendTileLetter(atlas, &letterQuads, (int)sx, (int)sy, game->currentLetter, red);
     }
+    Graphics_FlushBoardBatches(app, atlas, tileQuads, letterQuads);
 
     SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_BLEND);
     SDL_SetRenderDrawColor(app->renderer, 50, 40, 70, 240);
@@ -265,22 +760,18 @@ void Graphics_RenderGame(AppContext *app, GameState *game)
     sprintf(scoreText, "%s: %d   |   %s: %d   |   TURN: %s", p1Name, game->scores[0], p2Name, game->scores[1], turnName);
     Graphics_DrawText(app, app->fontRegular, scoreText, 15, 10, (SDL_Color){255, 255, 255, 255});
 
-    Uint32 elapsedTime = SDL_GetTicks() - game->gameStartTime;
-    Uint32 timeLeft = (elapsedTime >= GAME_DURATION_MS) ? 0 : GAME_DURATION_MS - elapsedTime;
+    Uint32 timeLeft = Graphics_Interpolate(game, game->prevGameTimeLeft, game->gameTimeLeft);
     int totalSeconds = timeLeft / 1000;
     char timerText[20];
     sprintf(timerText, "Time: %02d:%02d", totalSeconds / 60, totalSeconds % 60);
     int tw = 0, th = 0;
-    TTF_SizeText(app->fontRegular, timerText, &tw, &th);
+    Graphics_MeasureText(app, app->fontRegular, timerText, &tw, &th);
     Graphics_DrawText(app, app->fontRegular, timerText, WINDOW_WIDTH - tw - 20, 10, (SDL_Color){255, 255, 255, 255});
 
-    if (!game->isMultiplayer || game->currentPlayer == game->localPlayerId)
+    if (!game->isMultiplayer || game->isSpectator || game->currentPlayer == game->localPlayerId)
     {
         Uint32 turnLimit = (game->gameMode == 1) ? BLITZ_TURN_DURATION_MS : TURN_DURATION_MS;
-        Uint32 turnElapsed = SDL_GetTicks() - game->turnStartTime;
-        float ratio = 1.0f - ((float)turnElapsed / turnLimit);
-        if (ratio < 0)
-            ratio = 0;
+        float ratio = (float)Graphics_Interpolate(game, game->prevTurnTimeLeft, game->turnTimeLeft) / turnLimit;
         SDL_Rect barBg = {10, WINDOW_HEIGHT - 35, 200, 12};
         SDL_Rect barFg = {10, WINDOW_HEIGHT - 35, (int)(200 * ratio), 12};
         SDL_SetRenderDrawColor(app->renderer, 100, 50, 50, 255);
@@ -289,11 +780,30 @@ void Graphics_RenderGame(AppContext *app, GameState *game)
         SDL_RenderFillRect(app->renderer, &barFg);
     }
 
-    game->pauseButton.rect = (SDL_Rect){WINDOW_WIDTH - 250, WINDOW_HEIGHT - 50, 110, 40};
-    game->giveUpButton.rect = (SDL_Rect){WINDOW_WIDTH - 130, WINDOW_HEIGHT - 50, 110, 40};
-    game->pauseButton.text = game->isPaused ? "Resume" : "Pause";
-    Graphics_DrawButton(app, &game->pauseButton);
-    Graphics_DrawButton(app, &game->giveUpButton);
+    if (game->isSpectator)
+    {
+        Graphics_DrawText(app, app->fontRegular, "SPECTATING", WINDOW_WIDTH - 170, WINDOW_HEIGHT - 45, (SDL_Color){255, 220, 120, 255});
+    }
+    else
+    {
+        Graphics_DrawButton(app, &game->pauseButton);
+        Graphics_DrawButton(app, &game->giveUpButton);
+    }
+
+    if (game->isMultiplayer && game->isNetOverlayVisible)
+    {
+        NetworkStats stats;
+        Network_GetStats(&stats);
+        char netText[160];
+        int len = sprintf(netText, "%s  RTT %.1f ms  jitter %.1f ms", stats.isUdp ? "UDP" : "TCP", stats.rttMs, stats.jitterMs);
+        if (stats.isClockSynced)
+            len += sprintf(netText + len, "  clock %+d ms", stats.clockOffsetMs);
+        else
+            len += sprintf(netText + len, "  clock not synced");
+        if (stats.isUdp)
+            sprintf(netText + len, "  resent %d", stats.reliableResends);
+        Graphics_DrawText(app, app->fontRegular, netText, 15, 50, (SDL_Color){255, 255, 120, 255});
+    }
 
     if (game->isPaused)
     {
@@ -303,11 +813,21 @@ void Graphics_RenderGame(AppContext *app, GameState *game)
         SDL_RenderFillRect(app->renderer, &full);
         SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_NONE);
         Graphics_DrawTextCentered(app, app->fontLarge, "PAUSED", WINDOW_HEIGHT / 2 - 40, (SDL_Color){255, 255, 255, 255});
-        Graphics_DrawTextCentered(app, app->fontRegular, "Press any key to resume", WINDOW_HEIGHT / 2 + 10, (SDL_Color){200, 200, 200, 255});
+        Graphics_DrawTextCentered(app, app->fontRegular, game->isSpectator ? "Waiting for the players to resume" : "Press any key to resume", WINDOW_HEIGHT / 2 + 10, (SDL_Color){200, 200, 200, 255});
+    }
+    else if (game->isReconnecting)
+    {
+        SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 180);
+        SDL_Rect full = {0, 0, WINDOW_WIDTH, WINDOW_HEIGHT};
+        SDL_RenderFillRect(app->renderer, &full);
+        SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_NONE);
+        Graphics_DrawTextCentered(app, app->fontLarge, "RECONNECTING...", WINDOW_HEIGHT / 2 - 40, (SDL_Color){255, 255, 255, 255});
+        Graphics_DrawTextCentered(app, app->fontRegular, "The match resumes where it left off", WINDOW_HEIGHT / 2 + 10, (SDL_Color){200, 200, 200, 255});
     }
 }
 
-void Graphics_RenderGameOver(AppContext *app, GameState *game)
+void Graphics_RenderGameOver(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
     Graphics_DrawTextCentered(app, app->fontLarge, "GAME OVER", 100, (SDL_Color){90, 30, 140, 255});
@@ -372,11 +892,9 @@ void Graphics_RenderGameOver(AppContext *app, GameState *game)
     else
         sprintf(winnerText, "%s WINS!", winner == 0 ? p1Name : p2Name);
 
-    int pulse = (int)(sin(SDL_GetTicks() / 150.0) * 50) + 150;
+    int pulse = (int)(sin(Graphics_GetTicks() / 150.0) * 50) + 150;
     Graphics_DrawTextCentered(app, app->fontLarge, winnerText, 480, (SDL_Color){0, pulse, 0, 255});
 
-    game->playAgainButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 550, 200, 50};
-    game->backButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 620, 200, 50};
     Graphics_DrawButton(app, &game->playAgainButton);
     Graphics_DrawButton(app, &game->backButton);
 }
@@ -411,7 +929,7 @@ static void DrawExampleWord(AppContext *app, int startX, int startY, const char
         }
         char letter[2] = {word[i], '\0'};
         int ltw = 0, lth = 0;
-        TTF_SizeText(app->fontRegular, letter, &ltw, &lth);
+        Graphics_MeasureText(app, app->fontRegular, letter, &ltw, &lth);
         if (ltw == 0)
             ltw = 14;
         if (lth == 0)
@@ -419,13 +937,16 @@ static void DrawExampleWord(AppContext *app, int startX, int startY, const char
         Graphics_DrawText(app, app->fontRegular, letter, box.x + (boxSize - ltw) / 2, box.y + (boxSize - lth) / 2, whiteText);
     }
 }
-void Graphics_RenderMysteryTutorial(AppContext *app, GameState *game)
+void Graphics_RenderMysteryTutorial(AppContext *app, const GameState *game)
 {
     Graphics_DrawMysteryBackground(app);
     SDL_Color whiteText = {255, 255, 255, 255};
     SDL_Color lightBlueGray = {200, 200, 220, 255};
     Graphics_DrawText(app, app->fontLarge, "How To Play", 50, 50, whiteText);
-    Graphics_DrawText(app, app->fontRegular, "Guess the Mystery Word in 6 tries.", 50, 110, lightBlueGray);
+    if (game->isMysteryAdversarial)
+        Graphics_DrawText(app, app->fontRegular, "Shifting mode: the word changes to dodge every guess. 6 tries.", 50, 110, lightBlueGray);
+    else
+        Graphics_DrawText(app, app->fontRegular, "Guess the Mystery Word in 6 tries.", 50, 110, lightBlueGray);
     Graphics_DrawText(app, app->fontRegular, "- Each guess must be a valid 5-letter word.", 50, 160, lightBlueGray);
     Graphics_DrawText(app, app->fontRegular, "- The color of the tiles will change to show", 50, 200, lightBlueGray);
     Graphics_DrawText(app, app->fontRegular, "  how close your guess was to the word.", 50, 230, lightBlueGray);
@@ -440,10 +961,10 @@ void Graphics_RenderMysteryTutorial(AppContext *app, GameState *game)
     Graphics_DrawText(app, app->fontRegular, "U is not in the word in any spot.", 50, 590, lightBlueGray);
     Graphics_DrawTextCentered(app, app->fontRegular, "Press any key or click to start...", 700, (SDL_Color){150, 150, 180, 255});
 }
-void Graphics_RenderMystery(AppContext *app, GameState *game)
+void Graphics_RenderMystery(AppContext *app, const GameState *game)
 {
     Graphics_DrawMysteryBackground(app);
-    Graphics_DrawTextCentered(app, app->fontLarge, "Mystery Word", 30, (SDL_Color){255, 255, 255, 255});
+    Graphics_DrawTextCentered(app, app->fontLarge, game->isMysteryAdversarial ? "Mystery Word: Shifting" : "Mystery Word", 30, (SDL_Color){255, 255, 255, 255});
     SDL_SetRenderDrawColor(app->renderer, 60, 60, 90, 255);
     SDL_RenderDrawLine(app->renderer, 0, 90, WINDOW_WIDTH, 90);
     int boxSize = 65;
@@ -486,7 +1007,7 @@ void Graphics_RenderMystery(AppContext *app, GameState *game)
             {
                 char letter[2] = {game->mysteryGrid[r][c], '\0'};
                 int ltw = 0, lth = 0;
-                TTF_SizeText(app->fontLarge, letter, &ltw, &lth);
+                Graphics_MeasureText(app, app->fontLarge, letter, &ltw, &lth);
                 if (ltw == 0)
                     ltw = 20;
                 if (lth == 0)
@@ -496,11 +1017,10 @@ void Graphics_RenderMystery(AppContext *app, GameState *game)
         }
     }
     Graphics_DrawTextCentered(app, app->fontRegular, "Type your guess. Press ENTER to Submit.", WINDOW_HEIGHT - 60, (SDL_Color){150, 150, 180, 255});
-    game->backButton.rect = (SDL_Rect){20, 20, 100, 40};
-    game->backButton.text = "Quit";
-    Graphics_DrawButton(app, &game->backButton);
+    if (game->currentState == STATE_MYSTERY_PLAYING)
+        Graphics_DrawButton(app, &game->backButton); // the game-over screen lays it out elsewhere
 }
-void Graphics_RenderMysteryGameOver(AppContext *app, GameState *game)
+void Graphics_RenderMysteryGameOver(AppContext *app, const GameState *game)
 {
     Graphics_RenderMystery(app, game);
     SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_BLEND);
@@ -516,19 +1036,100 @@ void Graphics_RenderMysteryGameOver(AppContext *app, GameState *game)
         sprintf(msg, "The word was: %s", game->mysteryTarget);
         Graphics_DrawTextCentered(app, app->fontLarge, msg, 300, (SDL_Color){200, 80, 80, 255});
     }
-    game->playAgainButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 400, 200, 50};
-    game->backButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 480, 200, 50};
-    game->backButton.text = "Main Menu";
     Graphics_DrawButton(app, &game->playAgainButton);
     Graphics_DrawButton(app, &game->backButton);
 }
-void Graphics_RenderWaitingForOpponent(AppContext *app, GameState *game)
+void Graphics_RenderWaitingForOpponent(AppContext *app, const GameState *game)
 {
     Graphics_DrawAnimatedBackground(app);
-    int titleBob = (int)(sin(SDL_GetTicks() / 300.0) * 8);
+    int titleBob = (int)(sin(Graphics_GetTicks() / 300.0) * 8);
     Graphics_DrawTextCentered(app, app->fontLarge, "Waiting for Opponent...", 200 + titleBob, (SDL_Color){90, 30, 140, 255});
-    char ipText[100];
-    sprintf(ipText, "Your IP Address: %s", Network_GetLocalIP());
+    static char ipText[100] = "";
+    if (ipText[0] == '\0')
+        sprintf(ipText, "Your IP Address: %s", Network_GetLocalIP());
     Graphics_DrawTextCentered(app, app->fontRegular, ipText, 300 + titleBob, (SDL_Color){200, 50, 50, 255});
-    Graphics_DrawTextCentered(app, app->fontRegular, "Give this IP to Player 2 so they can join!", 380 + titleBob, (SDL_Color){100, 100, 100, 255});
-}
\ No newline at end of file
+    Graphics_DrawTextCentered(app, app->fontRegular, "Player 2 will see this game under Join, or can type this IP", 380 + titleBob, (SDL_Color){100, 100, 100, 255});
+}
+
+void Graphics_RenderScreen(AppContext *app, const GameState *game)
+{
+    switch (game->currentState)
+    {
+    case STATE_SPLASH: Graphics_RenderSplashScreen(app, game); break;
+    case STATE_MODE_MENU: Graphics_RenderModeMenu(app, game); break;
+    case STATE_OPPONENT_MENU: Graphics_RenderOpponentMenu(app, game); break;
+    case STATE_BOT_MENU: Graphics_RenderBotMenu(app, game); break;
+    case STATE_MULTIPLAYER_MENU: Graphics_RenderMultiplayerMenu(app, game); break;
+    case STATE_ENTER_IP: Graphics_RenderIPInput(app, game); break;
+    case STATE_GET_NAMES: Graphics_RenderNameInput(app, game); break;
+    case STATE_TUTORIAL: Graphics_RenderTutorial(app, game); break;
+    case STATE_WAITING_FOR_OPPONENT: Graphics_RenderWaitingForOpponent(app, game); break;
+    case STATE_PLAYING: Graphics_RenderGame(app, game); break;
+    case STATE_GAME_OVER: Graphics_RenderGameOver(app, game); break;
+    case STATE_MYSTERY_TUTORIAL: Graphics_RenderMysteryTutorial(app, game); break;
+    case STATE_MYSTERY_PLAYING: Graphics_RenderMystery(app, game); break;
+    case STATE_MYSTERY_GAMEOVER: Graphics_RenderMysteryGameOver(app, game); break;
+    default: break;
+    }
+}
+
+#if PROFILER_ENABLED
+#define PROFILER_PANEL_X (WINDOW_WIDTH - 390)
+#define PROFILER_PANEL_Y 10
+#define PROFILER_GRAPH_HEIGHT 60
+#define PROFILER_GRAPH_MAX_MS 50.0f
+
+static SDL_Vertex profilerBarVertices[PROFILE_HISTORY * 4];
+static int profilerBarIndices[PROFILE_HISTORY * 6];
+
+// Frame time graph (one bar per frame, green within a 60 Hz budget, yellow within two, red
+// beyond) over the last finished frame's phase times and counters. Toggled with F2.
+void Graphics_RenderProfilerOverlay(AppContext *app)
+{
+    const ProfileSnapshot *profile = Profiler_GetSnapshot();
+    SDL_Color textColor = {255, 255, 255, 255};
+
+    SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(app->renderer, 0, 0, 0, 190);
+    SDL_Rect panel = {PROFILER_PANEL_X, PROFILER_PANEL_Y, 380, 240};
+    SDL_RenderFillRect(app->renderer, &panel);
+    SDL_SetRenderDrawBlendMode(app->renderer, SDL_BLENDMODE_NONE);
+
+    float averageMs = 0.0f, maxMs = 0.0f;
+    int graphX = PROFILER_PANEL_X + 10, graphBottom = PROFILER_PANEL_Y + 40 + PROFILER_GRAPH_HEIGHT;
+    SDL_FRect noTexture = {0, 0, 0, 0};
+    for (int i = 0; i < PROFILE_HISTORY; i++)
+    {
+        float ms = profile->frameMs[(profile->newest + 1 + i) % PROFILE_HISTORY];
+        averageMs += ms / PROFILE_HISTORY;
+        if (ms > maxMs)
+            maxMs = ms;
+        float height = (ms > PROFILER_GRAPH_MAX_MS ? PROFILER_GRAPH_MAX_MS : ms) * PROFILER_GRAPH_HEIGHT / PROFILER_GRAPH_MAX_MS;
+        SDL_Color color = ms <= 17.0f ? (SDL_Color){90, 220, 110, 255} : ms <= 34.0f ? (SDL_Color){240, 210, 80, 255} : (SDL_Color){240, 80, 80, 255};
+        SDL_FRect bar = {(float)(graphX + i * 3), graphBottom - height, 2.0f, height};
+        Graphics_AppendQuad(profilerBarVertices, profilerBarIndices, i, bar, color, noTexture);
+    }
+    SDL_RenderGeometry(app->renderer, NULL, profilerBarVertices, PROFILE_HISTORY * 4, profilerBarIndices, PROFILE_HISTORY * 6);
+    int budgetY = graphBottom - (int)(16.7f * PROFILER_GRAPH_HEIGHT / PROFILER_GRAPH_MAX_MS);
+    SDL_SetRenderDrawColor(app->renderer, 150, 150, 150, 255);
+    SDL_RenderDrawLine(app->renderer, graphX, budgetY, graphX + PROFILE_HISTORY * 3, budgetY);
+
+    char line[96];
+    sprintf(line, "frame %.1f  avg %.1f  max %.1f ms", profile->frameMs[profile->newest], averageMs, maxMs);
+    Graphics_DrawText(app, app->fontRegular, line, PROFILER_PANEL_X + 10, PROFILER_PANEL_Y + 5, textColor);
+    sprintf(line, "sim %.2f  events %.2f ms", profile->phaseMs[PROFILE_SIMULATION], profile->phaseMs[PROFILE_EVENTS]);
+    Graphics_DrawText(app, app->fontRegular, line, PROFILER_PANEL_X + 10, graphBottom + 8, textColor);
+    sprintf(line, "net %.2f  render %.2f ms", profile->phaseMs[PROFILE_NETWORK], profile->phaseMs[PROFILE_RENDER]);
+    Graphics_DrawText(app, app->fontRegular, line, PROFILER_PANEL_X + 10, graphBottom + 36, textColor);
+    sprintf(line, "tex %d  ttf %d  dict %d  msgs %d", profile->counters[PROFILE_TEXTURE_CREATES], profile->counters[PROFILE_TTF_RENDERS],
+            profile->counters[PROFILE_DICTIONARY_LOOKUPS], profile->counters[PROFILE_NET_MESSAGES]);
+    Graphics_DrawText(app, app->fontRegular, line, PROFILER_PANEL_X + 10, graphBottom + 64, textColor);
+    AudioStats audio;
+    Audio_GetStats(&audio);
+    if (audio.frequency > 0)
+    {
+        sprintf(line, "audio %d smp  lat %.1f ms  xruns %d", audio.bufferSamples, audio.lastLatencyUs / 1000.0, audio.underruns);
+        Graphics_DrawText(app, app->fontRegular, line, PROFILER_PANEL_X + 10, graphBottom + 92, textColor);
+    }
+}
+#endif
@@ -2,10 +2,30 @@
 #include "../include/audio.h"
 #include "../include/logic.h"
 #include "../include/network.h"
+#include "../include/replay.h"
+#include "../include/save.h"
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
 
+// Text input belongs to the window, so the handlers only ask for it here and the render
+// thread switches it at its next frame. 0: nothing asked since then, 1: start, 2: stop.
+static SDL_atomic_t textInputRequest;
+
+void Input_SetTextInput(bool isActive)
+{
+    SDL_AtomicSet(&textInputRequest, isActive ? 1 : 2);
+}
+
+void Input_ApplyTextInput(void)
+{
+    int request = SDL_AtomicSet(&textInputRequest, 0);
+    if (request == 1)
+        SDL_StartTextInput();
+    else if (request == 2)
+        SDL_StopTextInput();
+}
+
 static bool Input_IsMouseOverButton(SDL_Event *event, Button *button)
 {
     int x = 0, y = 0;
@@ -32,13 +52,22 @@ void Input_HandleSplash(SDL_Event *event, GameState *game)
     {
         game->playWordsCollideButton.isHovered = Input_IsMouseOverButton(event, &game->playWordsCollideButton);
         game->playMysteryButton.isHovered = Input_IsMouseOverButton(event, &game->playMysteryButton);
+        game->playMysteryHardButton.isHovered = Input_IsMouseOverButton(event, &game->playMysteryHardButton);
     }
     else if (event->type == SDL_MOUSEBUTTONDOWN)
     {
         if (Input_IsMouseOverButton(event, &game->playWordsCollideButton))
             game->currentState = STATE_MODE_MENU;
         else if (Input_IsMouseOverButton(event, &game->playMysteryButton))
+        {
+            game->isMysteryAdversarial = false;
+            game->currentState = STATE_MYSTERY_TUTORIAL;
+        }
+        else if (Input_IsMouseOverButton(event, &game->playMysteryHardButton))
+        {
+            game->isMysteryAdversarial = true;
             game->currentState = STATE_MYSTERY_TUTORIAL;
+        }
     }
 }
 void Input_HandleModeMenu(SDL_Event *event, GameState *game)
@@ -86,7 +115,7 @@ void Input_HandleOpponentMenu(SDL_Event *event, GameState *game)
         {
             game->isSinglePlayer = false;
             game->currentState = STATE_GET_NAMES;
-            SDL_StartTextInput();
+            Input_SetTextInput(true);
         }
         else if (Input_IsMouseOverButton(event, &game->multiplayerButton))
         {
@@ -115,7 +144,7 @@ void Input_HandleBotMenu(SDL_Event *event, GameState *game)
             game->botDifficulty = 0;
             strcpy(game->playerNames[1], "Scribble Sprite");
             game->currentState = STATE_GET_NAMES;
-            SDL_StartTextInput();
+            Input_SetTextInput(true);
         }
         else if (Input_IsMouseOverButton(event, &game->botHardButton))
         {
@@ -123,7 +152,7 @@ void Input_HandleBotMenu(SDL_Event *event, GameState *game)
             game->botDifficulty = 1;
             strcpy(game->playerNames[1], "Lexicon Leviathan");
             game->currentState = STATE_GET_NAMES;
-            SDL_StartTextInput();
+            Input_SetTextInput(true);
         }
         else if (Input_IsMouseOverButton(event, &game->backButton))
             game->currentState = STATE_OPPONENT_MENU;
@@ -149,44 +178,44 @@ void Input_HandleMultiplayerMenu(SDL_Event *event, GameState *game)
                 game->localPlayerId = 0;
                 game->currentNameInput = 0;
                 game->currentState = STATE_GET_NAMES;
-                SDL_StartTextInput();
+                Input_SetTextInput(true);
             }
         }
         else if (Input_IsMouseOverButton(event, &game->joinGameButton))
         {
-            char foundIP[64] = "";
-            bool hostFound = false;
-            for (int i = 0; i < 25; i++)
-            {
-                if (Network_ListenForHost(foundIP))
-                {
-                    hostFound = true;
-                    break;
-                }
-                SDL_Delay(100);
-            }
-            if (hostFound)
-            {
-                if (Network_JoinGame(foundIP, 9021)) // FIX: Port updated to 9021
-                {
-                    game->isMultiplayer = true;
-                    game->localPlayerId = 1;
-                    game->currentNameInput = 1;
-                    game->currentState = STATE_GET_NAMES;
-                    SDL_StartTextInput();
-                }
-            }
-            else
-            {
-                memset(game->targetIP, 0, sizeof(game->targetIP));
-                game->currentState = STATE_ENTER_IP;
-                SDL_StartTextInput();
-            }
+            // Hosts show up on the join screen as they answer; typing an IP still works.
+            Network_StartBrowsing();
+            memset(game->targetIP, 0, sizeof(game->targetIP));
+            game->currentState = STATE_ENTER_IP;
+            Input_SetTextInput(true);
         }
         else if (Input_IsMouseOverButton(event, &game->backButton))
             game->currentState = STATE_OPPONENT_MENU;
     }
 }
+static bool Input_JoinHost(GameState *game, const char *ipAddress, int port)
+{
+    if (!Network_JoinGame(ipAddress, port))
+        return false;
+    Network_StopBrowsing();
+    game->isMultiplayer = true;
+    game->localPlayerId = 1;
+    game->currentNameInput = 1;
+    game->currentState = STATE_GET_NAMES;
+    Input_SetTextInput(true);
+    return true;
+}
+static int Input_GetClickedHost(SDL_Event *event, int hostCount)
+{
+    SDL_Point point = {event->button.x, event->button.y};
+    for (int i = 0; i < hostCount; i++)
+    {
+        SDL_Rect row = {100, HOST_LIST_Y + i * HOST_LIST_ROW_HEIGHT, WINDOW_WIDTH - 200, HOST_LIST_ROW_HEIGHT - 5};
+        if (SDL_PointInRect(&point, &row))
+            return i;
+    }
+    return -1;
+}
 void Input_HandleIPInput(SDL_Event *event, GameState *game)
 {
     if (event->type == SDL_QUIT)
@@ -195,14 +224,21 @@ void Input_HandleIPInput(SDL_Event *event, GameState *game)
         game->backButton.isHovered = Input_IsMouseOverButton(event, &game->backButton);
     else if (event->type == SDL_MOUSEBUTTONDOWN)
     {
+        DiscoveredHost hosts[HOST_LIST_ROWS];
+        int clickedHost = Input_GetClickedHost(event, Network_GetDiscoveredHosts(hosts, HOST_LIST_ROWS));
         if (Input_IsMouseOverButton(event, &game->backButton))
         {
+            Network_StopBrowsing();
             game->currentState = STATE_MULTIPLAYER_MENU;
-            SDL_StopTextInput();
+            Input_SetTextInput(false);
+        }
+        else if (clickedHost >= 0)
+        {
+            Input_JoinHost(game, hosts[clickedHost].ip, hosts[clickedHost].port);
         }
         else 
         {
-            SDL_StartTextInput(); // FIX: Clicking brings the keyboard back
+            Input_SetTextInput(true); // FIX: Clicking brings the keyboard back
         }
     }
     else if (event->type == SDL_KEYDOWN)
@@ -217,14 +253,7 @@ void Input_HandleIPInput(SDL_Event *event, GameState *game)
         {
             if (strlen(game->targetIP) > 0)
             {
-                if (Network_JoinGame(game->targetIP, 9021)) // FIX: Port updated to 9021
-                {
-                    game->isMultiplayer = true;
-                    game->localPlayerId = 1;
-                    game->currentNameInput = 1;
-                    game->currentState = STATE_GET_NAMES;
-                }
-                else
+                if (!Input_JoinHost(game, game->targetIP, NETWORK_PORT))
                     memset(game->targetIP, 0, sizeof(game->targetIP));
             }
         }
@@ -245,7 +274,7 @@ void Input_HandleNames(SDL_Event *event, GameState *game, AppContext *app)
         game->currentState = STATE_QUIT;
     else if (event->type == SDL_MOUSEBUTTONDOWN) 
     {
-        SDL_StartTextInput(); // FIX: Clicking brings the keyboard back
+        Input_SetTextInput(true); // FIX: Clicking brings the keyboard back
     }
     else if (event->type == SDL_KEYDOWN)
     {
@@ -262,21 +291,24 @@ void Input_HandleNames(SDL_Event *event, GameState *game, AppContext *app)
                 if (game->isMultiplayer)
                 {
                     game->playerReady[game->localPlayerId] = true;
-                    char msg[256];
-                    sprintf(msg, "READY,%d,%s\n", game->localPlayerId, game->playerNames[game->localPlayerId]);
-                    Network_SendMessage(msg);
+                    GameMessage msg = {.type = MSG_READY, .ready = {game->localPlayerId}};
+                    strcpy(msg.ready.name, game->playerNames[game->localPlayerId]);
+                    Network_SendMessage(&msg);
+                    if (game->localPlayerId == 0)
+                        Network_SetHostInfo(game->playerNames[0], false);
                     
                     // FIX: THE UI TRAP! Only wait if opponent isn't ready yet.
                     int opponentId = (game->localPlayerId == 0) ? 1 : 0;
                     if (game->playerReady[opponentId]) {
                         game->currentState = STATE_PLAYING;
-                        game->gameStartTime = SDL_GetTicks();
-                        game->turnStartTime = SDL_GetTicks();
+                        game->gameStartTime = game->simTime;
+                        game->turnStartTime = game->simTime;
+                        Logic_OnMatchStarted(game);
                     } else {
                         game->currentState = STATE_WAITING_FOR_OPPONENT;
                     }
                     
-                    SDL_StopTextInput();
+                    Input_SetTextInput(false);
                 }
                 else
                 {
@@ -287,8 +319,8 @@ void Input_HandleNames(SDL_Event *event, GameState *game, AppContext *app)
                     else
                     {
                         game->currentState = STATE_TUTORIAL;
-                        game->tutorialStartTime = SDL_GetTicks();
-                        SDL_StopTextInput();
+                        game->tutorialStartTime = game->simTime;
+                        Input_SetTextInput(false);
                         Audio_StopMusic();
                     }
                 }
@@ -310,18 +342,28 @@ void Input_HandleTutorial(SDL_Event *event, GameState *game)
 {
     if (event->type == SDL_QUIT)
         game->currentState = STATE_QUIT;
-    else if ((event->type == SDL_MOUSEBUTTONDOWN || event->type == SDL_KEYDOWN) && (SDL_GetTicks() - game->tutorialStartTime > 500))
+    else if ((event->type == SDL_MOUSEBUTTONDOWN || event->type == SDL_KEYDOWN) && (game->simTime - game->tutorialStartTime > 500))
     {
         game->currentState = STATE_PLAYING;
-        game->gameStartTime = SDL_GetTicks();
-        game->turnStartTime = SDL_GetTicks();
+        game->gameStartTime = game->simTime;
+        game->turnStartTime = game->simTime;
+        Replay_Begin(game);
     }
 }
 
+// Local actions the opponent has to see are also logged for resync and mirrored to spectators.
+static void Input_SendToPeer(GameState *game, const GameMessage *msg)
+{
+    Network_SendMessage(msg);
+    Logic_RecordMatchEvent(game, msg);
+}
+
 void Input_HandleGame(SDL_Event *event, GameState *game, AppContext *app)
 {
     if (event->type == SDL_QUIT)
         game->currentState = STATE_QUIT;
+    else if (game->isSpectator || game->isReconnecting)
+        return;
     else if (event->type == SDL_MOUSEMOTION)
     {
         game->giveUpButton.isHovered = Input_IsMouseOverButton(event, &game->giveUpButton);
@@ -336,27 +378,25 @@ void Input_HandleGame(SDL_Event *event, GameState *game, AppContext *app)
             Audio_StopMusic();
             Audio_PlaySound(app->sfxWin);
             game->currentState = STATE_GAME_OVER;
-            SDL_StopTextInput();
+            Input_SetTextInput(false);
             if (game->isMultiplayer)
-            {
-                char msg[64];
-                sprintf(msg, "GIVE_UP,%d\n", game->localPlayerId);
-                Network_SendMessage(msg);
-            }
+                Input_SendToPeer(game, &(GameMessage){.type = MSG_GIVE_UP, .giveUp = {game->localPlayerId}});
             return;
         }
         if (Input_IsMouseOverButton(event, &game->pauseButton))
         {
             game->isPaused = !game->isPaused;
             if (game->isMultiplayer)
-                Network_SendMessage(game->isPaused ? "PAUSE_ON\n" : "PAUSE_OFF\n");
+                Input_SendToPeer(game, &(GameMessage){.type = game->isPaused ? MSG_PAUSE_ON : MSG_PAUSE_OFF});
+            else if (game->isPaused)
+                Save_Write(game);
             return;
         }
         if (game->isPaused)
         {
             game->isPaused = false;
             if (game->isMultiplayer)
-                Network_SendMessage("PAUSE_OFF\n");
+                Input_SendToPeer(game, &(GameMessage){.type = MSG_PAUSE_OFF});
             return;
         }
         if (game->isSinglePlayer && game->currentPlayer == 1)
@@ -378,17 +418,19 @@ void Input_HandleGame(SDL_Event *event, GameState *game, AppContext *app)
                 game->isTileSelected = true;
                 game->selectedX = x;
                 game->selectedY = y;
-                SDL_StartTextInput();
+                Input_SetTextInput(true);
             }
         }
     }
+    else if (event->type == SDL_KEYDOWN && event->key.keysym.sym == SDLK_F3)
+        game->isNetOverlayVisible = !game->isNetOverlayVisible;
     else if (event->type == SDL_KEYDOWN)
     {
         if (game->isPaused)
         {
             game->isPaused = false;
             if (game->isMultiplayer)
-                Network_SendMessage("PAUSE_OFF\n");
+                Input_SendToPeer(game, &(GameMessage){.type = MSG_PAUSE_OFF});
             return;
         }
         if (game->isSinglePlayer && game->currentPlayer == 1)
@@ -397,28 +439,43 @@ void Input_HandleGame(SDL_Event *event, GameState *game, AppContext *app)
             return;
         if (game->isTileSelected && event->key.keysym.sym == SDLK_RETURN && game->currentLetter)
         {
+            Uint32 now = game->simTime;
+            GameMessage move = {.type = MSG_MOVE, .move = {.x = game->selectedX, .y = game->selectedY, .letter = game->currentLetter}};
             if (game->isMultiplayer)
             {
-                char msg[256];
-                sprintf(msg, "MOVE,%d,%d,%c\n", game->selectedX, game->selectedY, game->currentLetter);
-                Network_SendMessage(msg);
+                // Both peers start the next turn's clock at this instant, in the shared timebase.
+                Protocol_PutU32(move.move.turnStartMs, Network_LocalToSharedTicks(now));
+                Network_SendMessage(&move);
+            }
+            if (game->isServerMatch)
+            {
+                // The server validates the move and answers with STATE for both players.
+                game->isTileSelected = false;
+                game->currentLetter = '\0';
+                Input_SetTextInput(false);
+                return;
             }
-            game->totalTurnTime[game->currentPlayer] += (SDL_GetTicks() - game->turnStartTime);
-            game->turnsPlayed[game->currentPlayer]++;
-            game->grid[game->selectedX][game->selectedY] = game->currentLetter;
+            int mover = game->currentPlayer;
+            char letter = game->currentLetter;
+            game->totalTurnTime[mover] += (now - game->turnStartTime);
+            game->turnsPlayed[mover]++;
+            game->grid[game->selectedX][game->selectedY] = letter;
             Audio_PlaySound(app->sfxPlaceTile);
-            int score = Logic_CheckAndScore(game, game->selectedX, game->selectedY, game->currentLetter);
+            int score = Logic_CheckAndScore(game, game->selectedX, game->selectedY, letter);
             if (score > 0)
             {
                 Audio_PlaySound(app->sfxValidWord);
-                game->scores[game->currentPlayer] += score;
+                game->scores[mover] += score;
             }
-            game->currentPlayer = (game->currentPlayer + 1) % 2;
+            game->currentPlayer = (mover + 1) % 2;
             game->isTileSelected = false;
             game->currentLetter = '\0';
-            game->turnStartTime = SDL_GetTicks();
-            SDL_StopTextInput();
+            game->turnStartTime = now;
+            Input_SetTextInput(false);
+            Replay_RecordMove(game, game->selectedX, game->selectedY, letter, mover, score > 0 ? score : 0, score);
             Logic_CheckWinConditions(game, app);
+            if (game->isMultiplayer)
+                Logic_RecordMatchEvent(game, &move);
         }
     }
     else if (event->type == SDL_TEXTINPUT)
@@ -457,7 +514,7 @@ void Input_HandleMysteryTutorial(SDL_Event *event, GameState *game)
     {
         Logic_SetupMystery(game);
         game->currentState = STATE_MYSTERY_PLAYING;
-        SDL_StartTextInput();
+        Input_SetTextInput(true);
         Audio_StopMusic();
     }
 }
@@ -473,11 +530,11 @@ void Input_HandleMysteryPlaying(SDL_Event *event, GameState *game, AppContext *a
         if (Input_IsMouseOverButton(event, &game->backButton))
         {
             game->currentState = STATE_RESTART;
-            SDL_StopTextInput();
+            Input_SetTextInput(false);
         }
         else
         {
-            SDL_StartTextInput();
+            Input_SetTextInput(true);
         }
     }
     else if (event->type == SDL_KEYDOWN)
@@ -495,7 +552,7 @@ void Input_HandleMysteryPlaying(SDL_Event *event, GameState *game, AppContext *a
                 if (game->mysteryState > 0)
                 {
                     game->currentState = STATE_MYSTERY_GAMEOVER;
-                    SDL_StopTextInput();
+                    Input_SetTextInput(false);
                 }
             }
             else
@@ -532,7 +589,7 @@ void Input_HandleMysteryGameOver(SDL_Event *event, GameState *game)
         {
             Logic_SetupMystery(game);
             game->currentState = STATE_MYSTERY_PLAYING;
-            SDL_StartTextInput();
+            Input_SetTextInput(true);
         }
         else if (Input_IsMouseOverButton(event, &game->backButton))
             game->currentState = STATE_RESTART;
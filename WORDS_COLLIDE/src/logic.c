@@ -1,6 +1,9 @@
 #include "../include/logic.h"
+#include "../include/input.h"
 #include "../include/network.h"
 #include "../include/audio.h"
+#include "../include/profiler.h"
+#include "../include/replay.h"
 #include "../include/types.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,6 +14,99 @@
 static char dictionary[MAX_WORDS_IN_DICT][32];
 static int dictSize = 0;
 
+// Shifting Mystery candidates: every 5-letter dictionary word, stored one array per
+// letter position so the feedback kernel can sweep 64 candidates at a time.
+#define MAX_MYSTERY_CANDIDATES 16384
+#define MYSTERY_PATTERN_COUNT 243 // 3^5 gray/yellow/green combinations
+#define MYSTERY_ALL_GREEN (MYSTERY_PATTERN_COUNT - 1)
+static char candidateLetters[MYSTERY_COLS][MAX_MYSTERY_CANDIDATES];
+static Uint64 candidateLive[MAX_MYSTERY_CANDIDATES / 64];
+static Uint8 candidatePattern[MAX_MYSTERY_CANDIDATES];
+static int candidateCount = 0;
+
+static void Logic_BuildMysteryCandidates(void) {
+    candidateCount = 0;
+    for (int i = 0; i < dictSize && candidateCount < MAX_MYSTERY_CANDIDATES; i++) {
+        const char *word = dictionary[i];
+        if (strlen(word) != MYSTERY_COLS) continue;
+        bool isAlpha = true;
+        for (int c = 0; c < MYSTERY_COLS; c++) if (word[c] < 'A' || word[c] > 'Z') isAlpha = false;
+        if (!isAlpha) continue;
+        for (int c = 0; c < MYSTERY_COLS; c++) candidateLetters[c][candidateCount] = word[c];
+        candidateCount++;
+    }
+}
+
+// Feedback digits per position: 0 gray, 1 yellow, 2 green, packed base 3.
+// The k-th non-green occurrence of a letter in the guess is yellow iff the candidate
+// has more than k non-green copies of it, so every lane is independent and the
+// fixed 64-wide loops below auto-vectorize.
+static void Logic_MysteryFeedbackBlock(const char *guess, int base, int n, Uint8 *patternOut) {
+    Uint8 green[MYSTERY_COLS][64];
+    Uint8 pattern[64] = {0};
+    static const Uint8 pow3[MYSTERY_COLS] = {1, 3, 9, 27, 81};
+
+    for (int i = 0; i < MYSTERY_COLS; i++) {
+        const char *col = &candidateLetters[i][base];
+        for (int k = 0; k < 64; k++) {
+            green[i][k] = (k < n) & (col[k] == guess[i]);
+            pattern[k] += green[i][k] * 2 * pow3[i];
+        }
+    }
+    for (int i = 0; i < MYSTERY_COLS; i++) {
+        Uint8 rank[64] = {0};
+        Uint8 available[64] = {0};
+        for (int j = 0; j < i; j++) {
+            if (guess[j] != guess[i]) continue;
+            for (int k = 0; k < 64; k++) rank[k] += !green[j][k];
+        }
+        for (int j = 0; j < MYSTERY_COLS; j++) {
+            const char *col = &candidateLetters[j][base];
+            for (int k = 0; k < 64; k++) available[k] += (col[k] == guess[i]) & !green[j][k];
+        }
+        for (int k = 0; k < 64; k++) pattern[k] += (!green[i][k] & (available[k] > rank[k])) * pow3[i];
+    }
+    memcpy(patternOut, pattern, n);
+}
+
+// Adversarial judge: keeps whichever feedback bucket leaves the most candidates alive.
+static int Logic_PartitionMysteryCandidates(const char *guess) {
+    Uint64 startTicks = SDL_GetPerformanceCounter();
+    int bucket[MYSTERY_PATTERN_COUNT] = {0};
+    int blocks = (candidateCount + 63) / 64;
+
+    for (int b = 0; b < blocks; b++) {
+        Uint64 live = candidateLive[b];
+        if (!live) continue;
+        int base = b * 64;
+        int n = (candidateCount - base < 64) ? candidateCount - base : 64;
+        Logic_MysteryFeedbackBlock(guess, base, n, &candidatePattern[base]);
+        for (int k = 0; k < n; k++) {
+            if (live & ((Uint64)1 << k)) bucket[candidatePattern[base + k]]++;
+        }
+    }
+
+    // Ties go to the numerically lower pattern code.
+    int best = 0;
+    for (int p = 1; p < MYSTERY_PATTERN_COUNT; p++) {
+        if (bucket[p] > bucket[best]) best = p;
+    }
+
+    for (int b = 0; b < blocks; b++) {
+        Uint64 live = candidateLive[b];
+        if (!live) continue;
+        int base = b * 64;
+        int n = (candidateCount - base < 64) ? candidateCount - base : 64;
+        Uint64 keep = 0;
+        for (int k = 0; k < n; k++) keep |= (Uint64)(candidatePattern[base + k] == best) << k;
+        candidateLive[b] = live & keep;
+    }
+
+    double elapsedMs = (SDL_GetPerformanceCounter() - startTicks) * 1000.0 / SDL_GetPerformanceFrequency();
+    printf("Shifting Mystery: %d candidates left after %s (%.3f ms)\n", bucket[best], guess, elapsedMs);
+    return best;
+}
+
 void Logic_LoadDictionary(void) {
     FILE *file = fopen("assets/Dictionary.txt", "r");
     if (!file) {
@@ -32,9 +128,11 @@ void Logic_LoadDictionary(void) {
     }
     fclose(file);
     printf("Dictionary loaded: %d words.\n", dictSize);
+    Logic_BuildMysteryCandidates();
 }
 
 bool Logic_IsValidWord(const char *word) {
+    PROFILE_COUNT(PROFILE_DICTIONARY_LOOKUPS);
     for(int i=0; i < dictSize; i++) {
         if(strcmp(dictionary[i], word) == 0) return true;
     }
@@ -42,7 +140,11 @@ bool Logic_IsValidWord(const char *word) {
 }
 
 void Logic_InitGameState(GameState *game) {
+    Uint32 simTime = game->simTime; // the simulation clock outlives a restart
+    Uint64 simTickAt = game->simTickAt;
     memset(game, 0, sizeof(GameState));
+    game->simTime = simTime;
+    game->simTickAt = simTickAt;
     game->currentState = STATE_SPLASH;
 
     int midX = WINDOW_WIDTH / 2; // Usually 500
@@ -52,6 +154,8 @@ void Logic_InitGameState(GameState *game) {
     game->playWordsCollideButton.text = "Play WORDS COLLIDE";
     game->playMysteryButton.rect = (SDL_Rect){midX - 175, 380, 350, 60};
     game->playMysteryButton.text = "Play MYSTERY WORD";
+    game->playMysteryHardButton.rect = (SDL_Rect){midX - 175, 460, 350, 60};
+    game->playMysteryHardButton.text = "MYSTERY WORD: Shifting";
 
     // Modes
     game->classicModeButton.rect = (SDL_Rect){midX - 150, 300, 300, 50};
@@ -90,35 +194,37 @@ void Logic_InitGameState(GameState *game) {
     game->giveUpButton.text = "Give Up";
 }
 
-void Logic_CheckWinConditions(GameState *game, AppContext *app) {
-    if (game->currentState != STATE_PLAYING) return;
-    bool shouldEnd = false;
-
-    // RULE 1: 400 Point Limit
-    if (game->scores[0] >= 400 || game->scores[1] >= 400) {
-        strcpy(game->endReason, "Score Limit Reached (400+)!");
-        shouldEnd = true;
-    }
-    // RULE 2: 70 Point Mercy Lead
-    else if (abs(game->scores[0] - game->scores[1]) >= 70 && (game->scores[0] > 0 || game->scores[1] > 0)) {
-        strcpy(game->endReason, "Dominance! (70+ Point Lead)");
-        shouldEnd = true;
-    }
-    else {
-        // RULE 3: 85% Board Fill
-        int filled = 0;
-        for (int x = 0; x < GRID_COLS; x++) {
-            for (int y = 0; y < GRID_ROWS; y++) {
-                if (game->grid[x][y] != '\0') filled++;
-            }
-        }
-        if (filled >= (GRID_COLS * GRID_ROWS * 0.85f)) {
-            strcpy(game->endReason, "Board is 85% Full!");
-            shouldEnd = true;
-        }
+// Buttons that move or change label between screens. The renderer only reads a snapshot of
+// GameState, so this runs on the game thread and input hit-tests the rects that get drawn.
+void Logic_LayoutScreen(GameState *game) {
+    switch (game->currentState) {
+        case STATE_PLAYING:
+            game->pauseButton.rect = (SDL_Rect){WINDOW_WIDTH - 250, WINDOW_HEIGHT - 50, 110, 40};
+            game->giveUpButton.rect = (SDL_Rect){WINDOW_WIDTH - 130, WINDOW_HEIGHT - 50, 110, 40};
+            game->pauseButton.text = game->isPaused ? "Resume" : "Pause";
+            break;
+        case STATE_GAME_OVER:
+            game->playAgainButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 550, 200, 50};
+            game->backButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 620, 200, 50};
+            break;
+        case STATE_MYSTERY_PLAYING:
+            game->backButton.rect = (SDL_Rect){20, 20, 100, 40};
+            game->backButton.text = "Quit";
+            break;
+        case STATE_MYSTERY_GAMEOVER:
+            game->playAgainButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 400, 200, 50};
+            game->backButton.rect = (SDL_Rect){(WINDOW_WIDTH - 200) / 2, 480, 200, 50};
+            game->backButton.text = "Main Menu";
+            break;
+        default: break;
     }
+}
 
-    if (shouldEnd) {
+void Logic_CheckWinConditions(GameState *game, AppContext *app) {
+    if (game->currentState != STATE_PLAYING) return;
+    MatchEndReason reason = Rules_CheckEnd(game->grid, game->scores);
+    if (reason != END_NONE) {
+        strcpy(game->endReason, Rules_EndReasonText(reason));
         game->currentState = STATE_GAME_OVER;
         Audio_StopMusic();
         Audio_PlaySound(app->sfxWin);
@@ -126,7 +232,7 @@ void Logic_CheckWinConditions(GameState *game, AppContext *app) {
 }
 
 int Logic_CheckAndScore(GameState *game, int x, int y, char letter) {
-    int score = 10; // Base valid placement score
+    int score = Rules_ScorePlacement(game->grid, x, y, letter);
     if (score > game->bestWordScore) {
         game->bestWordScore = score;
         sprintf(game->bestWord, "%c-WORD", letter);
@@ -144,7 +250,8 @@ void Logic_BotMove(GameState *game, AppContext *app) {
                 game->scores[1] += 10;
                 game->turnsPlayed[1]++;
                 game->currentPlayer = 0;
-                game->turnStartTime = SDL_GetTicks();
+                game->turnStartTime = game->simTime;
+                Replay_RecordMove(game, x, y, game->grid[x][y], 1, 10, Rules_ScorePlacement(game->grid, x, y, game->grid[x][y]));
                 Audio_PlaySound(app->sfxPlaceTile);
                 Logic_CheckWinConditions(game, app);
                 return;
@@ -160,9 +267,48 @@ void Logic_SetupMystery(GameState *game) {
     game->mysteryCol = 0;
     game->mysteryState = 0;
     strcpy(game->mysteryTarget, "LOGIC");
+
+    // Without a dictionary there is nothing to shift between, so fall back to the fixed word.
+    if (game->isMysteryAdversarial && candidateCount == 0) game->isMysteryAdversarial = false;
+    if (game->isMysteryAdversarial) {
+        int blocks = (candidateCount + 63) / 64;
+        memset(candidateLive, 0xFF, blocks * sizeof(Uint64));
+        if (candidateCount % 64) candidateLive[blocks - 1] = ((Uint64)1 << (candidateCount % 64)) - 1;
+    }
+}
+
+static bool Logic_CheckMysteryRowAdversarial(GameState *game) {
+    char guess[MYSTERY_COLS + 1];
+    memcpy(guess, game->mysteryGrid[game->mysteryRow], MYSTERY_COLS);
+    guess[MYSTERY_COLS] = '\0';
+
+    int pattern = Logic_PartitionMysteryCandidates(guess);
+    for (int i = 0; i < MYSTERY_COLS; i++) {
+        game->mysteryColors[game->mysteryRow][i] = (pattern % 3) + 1;
+        pattern /= 3;
+    }
+
+    // Reveal a word the feedback so far is still consistent with.
+    int blocks = (candidateCount + 63) / 64;
+    for (int b = 0; b < blocks; b++) {
+        if (!candidateLive[b]) continue;
+        int idx = b * 64;
+        while (!(candidateLive[b] & ((Uint64)1 << (idx - b * 64)))) idx++;
+        for (int c = 0; c < MYSTERY_COLS; c++) game->mysteryTarget[c] = candidateLetters[c][idx];
+        game->mysteryTarget[MYSTERY_COLS] = '\0';
+        break;
+    }
+
+    if (strcmp(game->mysteryTarget, guess) == 0) game->mysteryState = 1;
+    else {
+        game->mysteryRow++;
+        if (game->mysteryRow >= MYSTERY_ROWS) game->mysteryState = 2;
+    }
+    return true;
 }
 
 bool Logic_CheckMysteryRow(GameState *game) {
+    if (game->isMysteryAdversarial) return Logic_CheckMysteryRowAdversarial(game);
     int correct = 0;
     for (int i = 0; i < 5; i++) {
         if (game->mysteryGrid[game->mysteryRow][i] == game->mysteryTarget[i]) {
@@ -180,41 +326,276 @@ bool Logic_CheckMysteryRow(GameState *game) {
     return true;
 }
 
-void Logic_HandleNetworkMessage(GameState *game, AppContext *app, char *msg) {
-    if (strncmp(msg, "READY", 5) == 0 || strncmp(msg, "READY_ACK", 9) == 0) {
-        int pIndex; char name[16];
-        sscanf(msg, "%*[^,],%d,%s", &pIndex, name);
-        strcpy(game->playerNames[pIndex], name);
-        game->playerReady[pIndex] = true;
-        
-        if (strncmp(msg, "READY", 5) == 0 && game->playerReady[game->localPlayerId]) {
-            char buf[64];
-            sprintf(buf, "READY_ACK,%d,%s\n", game->localPlayerId, game->playerNames[game->localPlayerId]);
-            Network_SendMessage(buf);
-        }
-        if (game->playerReady[0] && game->playerReady[1]) {
-            memset(game->grid, '\0', sizeof(game->grid));
-            game->gameStartTime = SDL_GetTicks();
-            game->turnStartTime = SDL_GetTicks();
-            game->currentState = STATE_PLAYING;
+// Match events (placements, pauses, resignations) numbered from 1, so a player whose
+// connection dropped can ask for exactly what it missed. Gaps older than the ring, or a
+// peer that is somehow ahead of us, are answered with a snapshot of the live state instead.
+#define MOVE_LOG_SIZE 64
+static GameMessage moveLog[MOVE_LOG_SIZE];
+static Uint32 moveLogSeq = 0;  // newest event
+static Uint32 moveLogBase = 0; // events up to here are only recoverable from a snapshot
+
+// Reconnect bookkeeping on the joining side.
+static int seenLinkGeneration = 0;
+static bool isAwaitingResync = false;
+static int resyncRemaining = 0;
+static int resyncBytes = 0;
+static Uint64 resumeSentAt = 0;
+
+// Set when a spectator update could not be queued; the next one goes out as a snapshot.
+static bool spectatorViewStale = false;
+
+static void Logic_OnReady(GameState *game, AppContext *app, const GameMessage *msg) {
+    int pIndex = msg->ready.playerId;
+    strcpy(game->playerNames[pIndex], msg->ready.name);
+    game->playerReady[pIndex] = true;
+
+    if (msg->type == MSG_READY && game->playerReady[game->localPlayerId]) {
+        GameMessage ack = {.type = MSG_READY_ACK, .ready = {game->localPlayerId}};
+        strcpy(ack.ready.name, game->playerNames[game->localPlayerId]);
+        Network_SendMessage(&ack);
+    }
+    if (game->playerReady[0] && game->playerReady[1]) {
+        memset(game->grid, '\0', sizeof(game->grid));
+        game->gameStartTime = game->simTime;
+        game->turnStartTime = game->simTime;
+        game->currentState = STATE_PLAYING;
+        Logic_OnMatchStarted(game);
+    }
+}
+
+// The mover stamps when the next turn began; converting that from the shared timebase
+// means both turn bars run out together instead of ours lagging by the one-way latency.
+static Uint32 Logic_TurnStartFromShared(const GameState *game, Uint32 sharedTicks) {
+    Uint32 now = game->simTime;
+    if (sharedTicks == 0 || !Network_IsClockSynced()) return now; // spectators never sync
+    Uint32 local = Network_SharedToLocalTicks(sharedTicks);
+    return ((Sint32)(now - local) < 0) ? now : local; // never in our future
+}
+
+static void Logic_OnMove(GameState *game, AppContext *app, const GameMessage *msg) {
+    int x = msg->move.x, y = msg->move.y;
+    char letter = msg->move.letter;
+    int mover = game->currentPlayer;
+    game->grid[x][y] = letter;
+    int score = Logic_CheckAndScore(game, x, y, letter);
+    if (score > 0) game->scores[mover] += score;
+    game->currentPlayer = (mover + 1) % 2;
+    game->turnStartTime = Logic_TurnStartFromShared(game, Protocol_GetU32(msg->move.turnStartMs));
+    Replay_RecordMove(game, x, y, letter, mover, score > 0 ? score : 0, score);
+    Logic_CheckWinConditions(game, app);
+}
+
+static void Logic_OnPauseOn(GameState *game, AppContext *app, const GameMessage *msg) { game->isPaused = true; }
+static void Logic_OnPauseOff(GameState *game, AppContext *app, const GameMessage *msg) { game->isPaused = false; }
+
+static void Logic_OnGiveUp(GameState *game, AppContext *app, const GameMessage *msg) {
+    game->forfeitedPlayer = msg->giveUp.playerId;
+    if (game->isSpectator) snprintf(game->endReason, sizeof(game->endReason), "%s Resigned", game->playerNames[msg->giveUp.playerId]);
+    else strcpy(game->endReason, "Opponent Resigned");
+    game->currentState = STATE_GAME_OVER;
+}
+
+// A dedicated server decides seats itself; keep whatever was typed under our old seat.
+static void Logic_OnAssign(GameState *game, AppContext *app, const GameMessage *msg) {
+    int seat = msg->assign.seat;
+    game->isServerMatch = true;
+    if (seat == game->localPlayerId) return;
+    char name[MAX_NAME_LENGTH];
+    strcpy(name, game->playerNames[seat]);
+    strcpy(game->playerNames[seat], game->playerNames[game->localPlayerId]);
+    strcpy(game->playerNames[game->localPlayerId], name);
+    bool ready = game->playerReady[seat];
+    game->playerReady[seat] = game->playerReady[game->localPlayerId];
+    game->playerReady[game->localPlayerId] = ready;
+    game->localPlayerId = seat;
+    game->currentNameInput = seat;
+}
+
+// Server matches never apply moves locally; this is the only place the board changes.
+static void Logic_OnState(GameState *game, AppContext *app, const GameMessage *msg) {
+    const StatePayload *state = &msg->state;
+    int mover = game->currentPlayer;
+    if (mover == game->localPlayerId && !game->isSpectator) {
+        game->totalTurnTime[mover] += (game->simTime - game->turnStartTime);
+        game->turnsPlayed[mover]++;
+    }
+    game->grid[state->x][state->y] = state->letter;
+    int rulesScore = Logic_CheckAndScore(game, state->x, state->y, state->letter);
+    int before = game->scores[mover];
+    game->scores[0] = Protocol_StateScore(state, 0);
+    game->scores[1] = Protocol_StateScore(state, 1);
+    if (resyncRemaining == 0) {
+        Audio_PlaySound(app->sfxPlaceTile);
+        if (game->scores[mover] > before) Audio_PlaySound(app->sfxValidWord);
+    }
+    game->currentPlayer = state->nextPlayer;
+    game->turnStartTime = Logic_TurnStartFromShared(game, Protocol_GetU32(state->turnStartMs));
+    Replay_RecordMove(game, state->x, state->y, state->letter, mover, game->scores[mover] - before, rulesScore);
+    Logic_CheckWinConditions(game, app);
+}
+
+// Opens (or resyncs) a spectator stream, or resyncs a player, at whatever point the match has reached.
+static void Logic_OnSnapshot(GameState *game, AppContext *app, const GameMessage *msg) {
+    const SnapshotPayload *snapshot = &msg->snapshot;
+    Uint32 now = game->simTime;
+    if (resyncRemaining == 0) game->isSpectator = true;
+    moveLogSeq = moveLogBase = Protocol_GetU32(snapshot->seq);
+    memcpy(game->grid, snapshot->grid, sizeof(game->grid));
+    for (int p = 0; p < 2; p++) {
+        game->scores[p] = (snapshot->scores[p][0] << 8) | snapshot->scores[p][1];
+        strcpy(game->playerNames[p], snapshot->names[p]);
+        game->playerReady[p] = true;
+    }
+    game->currentPlayer = snapshot->currentPlayer;
+    game->gameMode = snapshot->gameMode;
+    game->isPaused = snapshot->isPaused;
+    game->gameStartTime = now - Protocol_GetU32(snapshot->gameElapsedMs);
+    game->turnStartTime = now - Protocol_GetU32(snapshot->turnElapsedMs);
+    game->isTileSelected = false;
+    if (game->currentState != STATE_PLAYING) {
+        game->currentState = STATE_PLAYING;
+        Input_SetTextInput(false);
+    }
+    Replay_Begin(game);
+}
+
+static bool Logic_IsSpectatorHost(const GameState *game) {
+    return game->isMultiplayer && game->localPlayerId == 0 && !game->isServerMatch && !game->isSpectator;
+}
+
+static void Logic_FillSnapshot(const GameState *game, SnapshotPayload *snapshot) {
+    Uint32 now = game->simTime;
+    for (int p = 0; p < 2; p++) {
+        snapshot->scores[p][0] = (Uint8)(game->scores[p] >> 8);
+        snapshot->scores[p][1] = (Uint8)game->scores[p];
+        strcpy(snapshot->names[p], game->playerNames[p]);
+    }
+    snapshot->currentPlayer = (Uint8)game->currentPlayer;
+    snapshot->gameMode = (Uint8)game->gameMode;
+    snapshot->isPaused = game->isPaused;
+    Protocol_PutU32(snapshot->gameElapsedMs, now - game->gameStartTime);
+    Protocol_PutU32(snapshot->turnElapsedMs, now - game->turnStartTime);
+    Protocol_PutU32(snapshot->seq, moveLogSeq);
+    memcpy(snapshot->grid, game->grid, sizeof(snapshot->grid));
+}
+
+static void Logic_PublishSpectatorSnapshot(GameState *game) {
+    GameMessage msg = {.type = MSG_SNAPSHOT};
+    Logic_FillSnapshot(game, &msg.snapshot);
+    spectatorViewStale = !Network_PublishSpectatorUpdate(&msg);
+}
+
+void Logic_OnMatchStarted(GameState *game) {
+    Replay_Begin(game);
+    moveLogSeq = moveLogBase = 0;
+    resyncRemaining = 0;
+    isAwaitingResync = false;
+    if (!Logic_IsSpectatorHost(game)) return;
+    Logic_PublishSpectatorSnapshot(game);
+    Network_SetHostInfo(game->playerNames[0], true);
+}
+
+// Called after msg has been applied locally. Moves are logged and forwarded as STATE so
+// neither a resyncing player nor a spectator ever has to score anything itself.
+void Logic_RecordMatchEvent(GameState *game, const GameMessage *msg) {
+    if (!game->isMultiplayer || game->isServerMatch || game->isSpectator) return;
+    if (game->currentState != STATE_PLAYING && game->currentState != STATE_GAME_OVER) return;
+    GameMessage event = *msg;
+    switch (msg->type) {
+        case MSG_MOVE:
+            event.type = MSG_STATE;
+            event.state = Protocol_MakeState(msg->move.x, msg->move.y, msg->move.letter, game->currentPlayer, game->scores,
+                                             Protocol_GetU32(msg->move.turnStartMs));
+            break;
+        case MSG_STATE: case MSG_PAUSE_ON: case MSG_PAUSE_OFF: case MSG_GIVE_UP: break;
+        default: return;
+    }
+    moveLog[++moveLogSeq % MOVE_LOG_SIZE] = event;
+
+    if (!Logic_IsSpectatorHost(game)) return;
+    if (spectatorViewStale) Logic_PublishSpectatorSnapshot(game);
+    else spectatorViewStale = !Network_PublishSpectatorUpdate(&event);
+}
+
+// Host side: answer a returning player with the events it missed, all in one burst.
+static void Logic_OnResume(GameState *game, AppContext *app, const GameMessage *msg) {
+    if (game->localPlayerId != 0 || game->isServerMatch) return;
+    Uint32 lastSeq = Protocol_GetU32(msg->resume.lastSeq);
+    bool useSnapshot = lastSeq > moveLogSeq || lastSeq < moveLogBase || moveLogSeq - lastSeq > MOVE_LOG_SIZE;
+    int count = useSnapshot ? 1 : (int)(moveLogSeq - lastSeq);
+
+    GameMessage header = {.type = MSG_RESYNC};
+    Protocol_PutU32(header.resync.baseSeq, useSnapshot ? moveLogSeq : lastSeq);
+    header.resync.count[0] = (Uint8)(count >> 8);
+    header.resync.count[1] = (Uint8)count;
+    Network_SendMessage(&header);
+    int bytes = Protocol_BinarySize(&header);
+    if (useSnapshot) {
+        GameMessage snapshot = {.type = MSG_SNAPSHOT};
+        Logic_FillSnapshot(game, &snapshot.snapshot);
+        Network_SendMessage(&snapshot);
+        bytes += Protocol_BinarySize(&snapshot);
+    } else {
+        for (Uint32 seq = lastSeq + 1; seq <= moveLogSeq; seq++) {
+            Network_SendMessage(&moveLog[seq % MOVE_LOG_SIZE]);
+            bytes += Protocol_BinarySize(&moveLog[seq % MOVE_LOG_SIZE]);
         }
     }
-    else if (strncmp(msg, "MOVE", 4) == 0) {
-        int x, y; char letter;
-        sscanf(msg, "MOVE,%d,%d,%c", &x, &y, &letter);
-        game->grid[x][y] = letter;
-        int score = Logic_CheckAndScore(game, x, y, letter);
-        if (score > 0) game->scores[game->currentPlayer] += score;
-        game->currentPlayer = (game->currentPlayer + 1) % 2;
-        game->turnStartTime = SDL_GetTicks();
-        Logic_CheckWinConditions(game, app);
-    }
-    else if (strncmp(msg, "PAUSE_ON", 8) == 0) game->isPaused = true;
-    else if (strncmp(msg, "PAUSE_OFF", 9) == 0) game->isPaused = false;
-    else if (strncmp(msg, "GIVE_UP", 7) == 0) {
-        int pId; sscanf(msg, "GIVE_UP,%d", &pId);
-        game->forfeitedPlayer = pId;
-        strcpy(game->endReason, "Opponent Resigned");
-        game->currentState = STATE_GAME_OVER;
+    printf("Network: peer resumed at seq %u/%u, sent %s (%d messages, %d bytes)\n",
+           (unsigned)lastSeq, (unsigned)moveLogSeq, useSnapshot ? "a snapshot" : "deltas", count, bytes);
+}
+
+static void Logic_FinishResync(void) {
+    double ms = (SDL_GetPerformanceCounter() - resumeSentAt) * 1000.0 / SDL_GetPerformanceFrequency();
+    printf("Network: back in sync at seq %u, %.1f ms after RESUME, %d bytes received\n", (unsigned)moveLogSeq, ms, resyncBytes);
+}
+
+static void Logic_OnResync(GameState *game, AppContext *app, const GameMessage *msg) {
+    isAwaitingResync = false;
+    moveLogSeq = Protocol_GetU32(msg->resync.baseSeq);
+    resyncRemaining = (msg->resync.count[0] << 8) | msg->resync.count[1];
+    resyncBytes = Protocol_BinarySize(msg);
+    if (resyncRemaining == 0) Logic_FinishResync();
+}
+
+// Notices the link dropping and coming back; the joining side then asks to resume.
+void Logic_UpdateConnection(GameState *game) {
+    if (game->isServerMatch || game->isSpectator) return;
+    int generation = Network_GetLinkGeneration();
+    bool isReconnect = seenLinkGeneration > 0 && generation != seenLinkGeneration;
+    bool isInMatch = game->currentState == STATE_PLAYING;
+    seenLinkGeneration = generation;
+    if (isReconnect && isInMatch && game->localPlayerId == 1) {
+        GameMessage resume = {.type = MSG_RESUME};
+        Protocol_PutU32(resume.resume.lastSeq, moveLogSeq);
+        Network_SendMessage(&resume);
+        resumeSentAt = SDL_GetPerformanceCounter();
+        isAwaitingResync = true;
+        printf("Network: reconnected, resuming after seq %u\n", (unsigned)moveLogSeq);
+    }
+    game->isReconnecting = isInMatch && (!Network_IsConnected() || isAwaitingResync || resyncRemaining > 0);
+}
+
+typedef void (*MessageHandler)(GameState *game, AppContext *app, const GameMessage *msg);
+static const MessageHandler messageHandlers[MSG_COUNT] = {
+    [MSG_READY] = Logic_OnReady,
+    [MSG_READY_ACK] = Logic_OnReady,
+    [MSG_MOVE] = Logic_OnMove,
+    [MSG_PAUSE_ON] = Logic_OnPauseOn,
+    [MSG_PAUSE_OFF] = Logic_OnPauseOff,
+    [MSG_GIVE_UP] = Logic_OnGiveUp,
+    [MSG_ASSIGN] = Logic_OnAssign,
+    [MSG_STATE] = Logic_OnState,
+    [MSG_SNAPSHOT] = Logic_OnSnapshot,
+    [MSG_RESUME] = Logic_OnResume,
+    [MSG_RESYNC] = Logic_OnResync,
+};
+
+void Logic_HandleNetworkMessage(GameState *game, AppContext *app, const GameMessage *msg) {
+    messageHandlers[msg->type](game, app, msg);
+    Logic_RecordMatchEvent(game, msg);
+    if (resyncRemaining > 0 && msg->type != MSG_RESYNC) {
+        resyncBytes += Protocol_BinarySize(msg);
+        if (--resyncRemaining == 0) Logic_FinishResync();
     }
-}
\ No newline at end of file
+}
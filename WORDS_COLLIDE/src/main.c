@@ -1,105 +1,152 @@
-#include "../include/graphics.h"
 #include "../include/input.h"
 #include "../include/logic.h"
+#include "../include/assets.h"
 #include "../include/audio.h"
+#include "../include/board.h"
+#include "../include/frame.h"
 #include "../include/network.h"
+#include "../include/profiler.h"
+#include "../include/protocol.h"
+#include "../include/renderbench.h"
+#include "../include/renderthread.h"
+#include "../include/replay.h"
+#include "../include/save.h"
+#include "../include/simulation.h"
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
-int main(int argc, char* argv[]) {
-    AppContext app = {0};
-    GameState game = {0};
-
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) return -1;
-    if (TTF_Init() < 0) return -1;
-    Network_Init();
-    Audio_Init(&app); 
-
-    app.window = SDL_CreateWindow("Words Collide", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
-    app.renderer = SDL_CreateRenderer(app.window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-
-    // FIXED: Properly loading from assets folder
-    app.fontLarge = TTF_OpenFont("assets/arial.ttf", 52);
-    app.fontRegular = TTF_OpenFont("assets/arial.ttf", 24);
-
-    Logic_InitGameState(&game);
-    Logic_LoadDictionary();
+typedef struct {
+    AppContext *app;
+    GameState *game;
+} GameLoopContext;
 
+// Runs on the game thread; main keeps the window, the renderer and the event pump.
+static int Main_GameLoop(void *data) {
+    AppContext *app = ((GameLoopContext *)data)->app;
+    GameState *game = ((GameLoopContext *)data)->game;
     bool running = true;
     SDL_Event event;
-    char netBuffer[1024];
+    NetMessage netMessages[NET_MAX_MESSAGES_PER_FRAME];
+
+    while (running && game->currentState != STATE_QUIT) {
+        bool hasEvent = Frame_WaitForEvent(game, &event);
+        Assets_ResolveAudio(app);
 
-    while (running && game.currentState != STATE_QUIT) {
-        while (SDL_PollEvent(&event)) {
+        // Fixed-timestep rules: bot turns, timers, highlight expiry
+        PROFILE_BEGIN(PROFILE_SIMULATION);
+        Simulation_Advance(game, app);
+        PROFILE_END(PROFILE_SIMULATION);
+
+        PROFILE_BEGIN(PROFILE_EVENTS);
+        for (; hasEvent; hasEvent = RenderThread_NextEvent(&event, 0)) {
             if (event.type == SDL_QUIT) { running = false; break; }
+            if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F2 && !event.key.repeat) PROFILE_TOGGLE_OVERLAY();
             
-            switch (game.currentState) {
-                case STATE_SPLASH: Input_HandleSplash(&event, &game); break;
-                case STATE_MODE_MENU: Input_HandleModeMenu(&event, &game); break;
-                case STATE_OPPONENT_MENU: Input_HandleOpponentMenu(&event, &game); break;
-                case STATE_BOT_MENU: Input_HandleBotMenu(&event, &game); break;
-                case STATE_MULTIPLAYER_MENU: Input_HandleMultiplayerMenu(&event, &game); break;
-                case STATE_ENTER_IP: Input_HandleIPInput(&event, &game); break;
-                case STATE_GET_NAMES: Input_HandleNames(&event, &game, &app); break;
-                case STATE_TUTORIAL: Input_HandleTutorial(&event, &game); break;
-                case STATE_PLAYING: Input_HandleGame(&event, &game, &app); break;
-                case STATE_GAME_OVER: Input_HandleGameOver(&event, &game); break;
-                case STATE_MYSTERY_TUTORIAL: Input_HandleMysteryTutorial(&event, &game); break;
-                case STATE_MYSTERY_PLAYING: Input_HandleMysteryPlaying(&event, &game, &app); break;
-                case STATE_MYSTERY_GAMEOVER: Input_HandleMysteryGameOver(&event, &game); break;
-                case STATE_RESTART: Logic_InitGameState(&game); break;
+            switch (game->currentState) {
+                case STATE_SPLASH: Input_HandleSplash(&event, game); break;
+                case STATE_MODE_MENU: Input_HandleModeMenu(&event, game); break;
+                case STATE_OPPONENT_MENU: Input_HandleOpponentMenu(&event, game); break;
+                case STATE_BOT_MENU: Input_HandleBotMenu(&event, game); break;
+                case STATE_MULTIPLAYER_MENU: Input_HandleMultiplayerMenu(&event, game); break;
+                case STATE_ENTER_IP: Input_HandleIPInput(&event, game); break;
+                case STATE_GET_NAMES: Input_HandleNames(&event, game, app); break;
+                case STATE_TUTORIAL: Input_HandleTutorial(&event, game); break;
+                case STATE_PLAYING: Input_HandleGame(&event, game, app); break;
+                case STATE_GAME_OVER: Input_HandleGameOver(&event, game); break;
+                case STATE_MYSTERY_TUTORIAL: Input_HandleMysteryTutorial(&event, game); break;
+                case STATE_MYSTERY_PLAYING: Input_HandleMysteryPlaying(&event, game, app); break;
+                case STATE_MYSTERY_GAMEOVER: Input_HandleMysteryGameOver(&event, game); break;
+                case STATE_RESTART: Logic_InitGameState(game); break;
                 default: break;
             }
         }
-
-        // Bot Timer logic
-        if (game.isSinglePlayer && game.currentState == STATE_PLAYING && game.currentPlayer == 1) {
-            if (SDL_GetTicks() - game.turnStartTime > 1500) {
-                Logic_BotMove(&game, &app);
-            }
-        }
+        PROFILE_END(PROFILE_EVENTS);
 
         // Network processing
-        if (game.isMultiplayer) {
-            if (Network_ReceiveMessage(netBuffer, sizeof(netBuffer)) > 0) {
-                Logic_HandleNetworkMessage(&game, &app, netBuffer);
-            }
-            if (game.currentState == STATE_WAITING_FOR_OPPONENT && game.localPlayerId == 0) {
-                Network_BroadcastPresence(game.playerNames[0]);
+        PROFILE_BEGIN(PROFILE_NETWORK);
+        if (game->isMultiplayer) {
+            int messageCount = Network_ReceiveMessages(netMessages, NET_MAX_MESSAGES_PER_FRAME);
+            PROFILE_ADD(PROFILE_NET_MESSAGES, messageCount);
+            for (int i = 0; i < messageCount; i++) {
+                Logic_HandleNetworkMessage(game, app, &netMessages[i].message);
+                Network_MarkApplied(&netMessages[i]);
             }
+            Logic_UpdateConnection(game);
         }
+        PROFILE_END(PROFILE_NETWORK);
 
-        // Render Frame
-        SDL_RenderClear(app.renderer);
-        switch (game.currentState) {
-            case STATE_SPLASH: Graphics_RenderSplashScreen(&app, &game); break;
-            case STATE_MODE_MENU: Graphics_RenderModeMenu(&app, &game); break;
-            case STATE_OPPONENT_MENU: Graphics_RenderOpponentMenu(&app, &game); break;
-            case STATE_BOT_MENU: Graphics_RenderBotMenu(&app, &game); break;
-            case STATE_MULTIPLAYER_MENU: Graphics_RenderMultiplayerMenu(&app, &game); break;
-            case STATE_ENTER_IP: Graphics_RenderIPInput(&app, &game); break;
-            case STATE_GET_NAMES: Graphics_RenderNameInput(&app, &game); break;
-            case STATE_TUTORIAL: Graphics_RenderTutorial(&app, &game); break;
-            case STATE_WAITING_FOR_OPPONENT: Graphics_RenderWaitingForOpponent(&app, &game); break;
-            case STATE_PLAYING: Graphics_RenderGame(&app, &game); break;
-            case STATE_GAME_OVER: Graphics_RenderGameOver(&app, &game); break;
-            case STATE_MYSTERY_TUTORIAL: Graphics_RenderMysteryTutorial(&app, &game); break;
-            case STATE_MYSTERY_PLAYING: Graphics_RenderMystery(&app, &game); break;
-            case STATE_MYSTERY_GAMEOVER: Graphics_RenderMysteryGameOver(&app, &game); break;
-            default: break;
+        // Hand this iteration's state to the render thread
+        Logic_LayoutScreen(game);
+        RenderThread_Publish(game);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    AppContext app = {.launchedAt = SDL_GetPerformanceCounter()};
+    GameState game = {0};
+
+    if (argc > 1 && strcmp(argv[1], "--bench-protocol") == 0) {
+        Protocol_RunBenchmark();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-board") == 0) {
+        Board_RunBenchmark();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-audio") == 0) {
+        return Audio_RunBenchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-render") == 0) {
+        int frames = 300;
+        const char *dumpDir = NULL, *compareDir = NULL;
+        for (int i = 2; i < argc; i++) {
+            if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = atoi(argv[++i]);
+            else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) dumpDir = argv[++i];
+            else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc) compareDir = argv[++i];
         }
-        SDL_RenderPresent(app.renderer);
-        SDL_Delay(16);
+        return RenderBench_Run(frames, dumpDir, compareDir);
+    }
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        int turn = -1;
+        if (argc > 4 && strcmp(argv[3], "--turn") == 0) turn = atoi(argv[4]);
+        return Replay_Run(argv[2], turn);
     }
+    bool useUdp = argc > 1 && strcmp(argv[1], "--udp") == 0; // join over UDP; hosts accept either
+
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) return -1;
+    if (TTF_Init() < 0) return -1;
+    Network_Init();
+    if (useUdp) Network_SetTransport(NET_TRANSPORT_UDP);
+    Assets_StartLoading(&app); // fonts and audio land while the first frames are drawn
+
+    app.window = SDL_CreateWindow("Words Collide", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
+
+    Logic_InitGameState(&game);
+    Logic_LoadDictionary();
+    Simulation_Init(&game);
+    if (Save_Load(&game)) { // an unfinished local match picks up where it left off
+        Simulation_SyncClocks(&game);
+        Replay_Begin(&game);
+    }
+    Logic_LayoutScreen(&game);
+    if (!RenderThread_Start(&app, &game)) return -1; // this thread owns the window, so it also renders
+
+    GameLoopContext context = {&app, &game};
+    RenderThread_Run(Main_GameLoop, &context);
 
+    RenderThread_Stop();
+    Assets_FinishLoading(&app);
+    Save_Write(&game); // refreshes the match clock in the save; no-op unless a local match is running
+    Replay_Finish();
     Network_Cleanup();
     Audio_Cleanup(&app);
-    if (app.fontLarge) TTF_CloseFont(app.fontLarge);
-    if (app.fontRegular) TTF_CloseFont(app.fontRegular);
-    SDL_DestroyRenderer(app.renderer);
+    Frame_Report();
+    Assets_Cleanup(&app);
     SDL_DestroyWindow(app.window);
     TTF_Quit();
     SDL_Quit();
@@ -1,95 +1,1332 @@
 #include "../include/network.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #ifdef _WIN32
 #include <winsock2.h>
 #endif
 
+// Everything TCP runs on the network thread. The game loop only talks to it through
+// the two single-producer/single-consumer queues below.
 static TCPsocket s_serverSocket = NULL; 
 static TCPsocket s_socket = NULL;       
+static void *s_joinedSocket = NULL; // handed from Network_JoinGame to the thread
 static SDLNet_SocketSet s_socketSet = NULL;
-static bool s_isConnected = false;
+static SDL_atomic_t s_isConnected;
+static SDL_atomic_t s_threadRunning;
+static SDL_Thread *s_thread = NULL;
+static bool s_sendBinary = false;
+static bool s_recvBinary = false;
+static SDL_atomic_t s_linkGeneration; // bumped on every (re)connect
 
+// A joining client keeps the host's address and redials it if the link drops.
+#define NET_REDIAL_INTERVAL_MS 1000
+static IPaddress s_peerAddress;
+static bool s_hasPeerAddress = false;
+static Uint32 s_lastRedial = 0;
+// The host picks a token when its first player links and sends it in HELLO; the joiner
+// sends it back when it redials, which is how the host tells its player from a newcomer.
+// While the link is down, newcomers wait in a short list until their HELLO line arrives.
+#define NET_RESUME_HELLO_MS 500
+#define NET_MAX_CANDIDATES 4
+typedef struct {
+    TCPsocket socket;
+    char received[128];
+    int len;
+    Uint32 acceptedAt;
+} NetCandidate;
+static Uint32 s_sessionToken = 0;
+static NetCandidate s_candidates[NET_MAX_CANDIDATES];
+static int s_candidateCount = 0;
+static SDLNet_SocketSet s_candidateSet = NULL;
+
+// LAN discovery has its own thread so the join screen never blocks. A joiner broadcasts
+// a probe as soon as it starts browsing and once a second after that; a host answers each
+// probe at once with an announcement formatted only when its name or status changes.
+// Hosts that stop answering drop off the list after NET_HOST_TTL_MS.
+#define NET_DISCOVERY_PORT 8888
+#define NET_DISCOVERY_PACKET_SIZE 128
+#define NET_PROBE_INTERVAL_MS 1000
+#define NET_HOST_TTL_MS 3000
+#define NET_DISCOVERY_PROBE "WORDS_COLLIDE?"
+static SDL_Thread *s_discoveryThread = NULL;
+static SDL_atomic_t s_discoveryRunning;
+static SDL_atomic_t s_isAnnouncing, s_isBrowsing, s_probeRequested;
+static UDPsocket s_announceSocket = NULL; // discovery thread only
+static UDPsocket s_probeSocket = NULL;    // discovery thread only
+static SDLNet_SocketSet s_discoverySet = NULL;
+static SDL_mutex *s_discoveryLock = NULL; // guards everything below
+static int s_hostPort = 0;
+static char s_announcement[NET_DISCOVERY_PACKET_SIZE];
+static int s_announcementLen = 0;
+static DiscoveredHost s_hosts[NET_MAX_DISCOVERED_HOSTS];
+static Uint32 s_hostSeenAt[NET_MAX_DISCOVERED_HOSTS];
+static int s_hostCount = 0;
+static Uint32 s_browseStartedAt = 0;
+static bool s_hasFoundHost = false;
+
+// Receive ring (network thread only). Positions are free-running byte counters
+// masked on access, so length is always s_writePos - s_readPos and nothing is shifted.
+#define NET_RING_SIZE 8192
+#define NET_RING_MASK (NET_RING_SIZE - 1)
+static char s_ring[NET_RING_SIZE];
+static char s_wrapScratch[NET_RING_SIZE + 1];
+static Uint32 s_readPos = 0;
+static Uint32 s_scanPos = 0;
+static Uint32 s_writePos = 0;
+
+// Lock-free SPSC queue: the producer only writes tail, the consumer only writes head.
+#define NET_QUEUE_CAPACITY 256
+#define NET_QUEUE_MASK (NET_QUEUE_CAPACITY - 1)
+typedef struct {
+    NetMessage slots[NET_QUEUE_CAPACITY];
+    SDL_atomic_t head;
+    SDL_atomic_t tail;
+    SDL_atomic_t maxDepth;
+} NetQueue;
+
+static NetQueue s_inbound;  // network thread -> game loop
+static NetQueue s_outbound; // game loop -> network thread
+
+static SDL_atomic_t s_sendStallUs;
+static SDL_atomic_t s_inboundStallUs;
+static SDL_atomic_t s_messagesSent;
+static SDL_atomic_t s_sendBatches;
+static SDL_atomic_t s_outboundDropped;
+
+// Spectators (host only). The match thread accepts them once the opponent is in and hands
+// them over to the spectator thread, which encodes pending updates once per pass and queues
+// the bytes for every viewer. Each viewer has its own sender thread behind a bounded queue,
+// so one that stops reading only ever blocks that thread: it skips deltas that no longer fit
+// and catches up from a snapshot, and is dropped once its queue has not moved for a while.
+#define NET_MAX_SPECTATORS 32
+#define NET_SPECTATOR_ACCEPT_MS 100
+#define NET_SPECTATOR_RESYNC_MS 1000    // viewers get a fresh snapshot at most this often
+#define NET_SPECTATOR_QUEUE_BYTES 131072 // holds a full pass of deltas
+#define NET_SPECTATOR_SEND_CHUNK 8192    // progress is noted after each chunk
+#define NET_SPECTATOR_TIMEOUT_MS 5000    // a queue stuck this long means the viewer has gone
+typedef struct {
+    TCPsocket socket;
+    SDL_mutex *lock;
+    SDL_cond *wake;
+    // Ring of queued bytes. The spectator thread appends at head under the lock; the sender
+    // sends from tail without it, since nothing else touches the queued bytes.
+    Uint8 queue[NET_SPECTATOR_QUEUE_BYTES];
+    Uint32 head, tail;
+    Uint32 lastProgressAt; // when bytes last left the queue, or it last stopped being empty
+    bool hasFailed;        // a send failed: the viewer has gone
+    bool isClosing;        // the sender closes the socket and frees the viewer
+    // Spectator thread only.
+    bool needsSnapshot;
+    Uint32 lastSnapshotAt;
+} Spectator;
+
+static Spectator *s_spectators[NET_MAX_SPECTATORS];
+static int s_spectatorCount = 0;
+static void *s_pendingSpectator = NULL; // match thread -> spectator thread
+static NetQueue s_spectatorUpdates;     // game loop -> spectator thread
+static SDL_Thread *s_spectatorThread = NULL;
+static SDLNet_SocketSet s_spectatorSet = NULL;
+static Uint32 s_lastSpectatorAccept = 0;
+static SnapshotPayload s_view; // spectator thread's running copy of the match
+static Uint32 s_viewGameStart = 0, s_viewTurnStart = 0;
+static bool s_hasView = false;
+static SDL_atomic_t s_isSpectating; // this client joined a match that was already running
+
+static int s_spectatorsServed = 0, s_spectatorsDropped = 0, s_spectatorResyncs = 0;
+static int s_fanOutBatches = 0, s_fanOutEncodes = 0, s_fanOutSends = 0;
+
+// Clock sync (network thread). Timestamps are microseconds on SDL_GetTicks' epoch, so
+// the offset applies directly to the tick values the game keeps. The host is the reference.
+#define NET_PING_INTERVAL_MS 1000
+#define NET_CLOCK_SAMPLES 8
+static Uint64 s_clockAnchorUs = 0;
+static Uint64 s_clockAnchorPerf = 0;
+static Uint32 s_lastPing = 0;
+static Sint64 s_sampleOffsetUs[NET_CLOCK_SAMPLES];
+static Sint64 s_sampleRttUs[NET_CLOCK_SAMPLES];
+static int s_sampleCount = 0;
+static double s_smoothedRttUs = 0.0, s_rttVarianceUs = 0.0;
+static SDL_atomic_t s_rttUs, s_jitterUs, s_clockOffsetMs, s_isClockSynced;
+
+static Uint64 s_appliedCount = 0;
+static Uint64 s_latencyTotal = 0;
+static Uint64 s_latencyMax = 0;
+static int s_maxBurst = 0;
+
+// UDP transport (network thread, see Network_SetTransport). Every datagram carries its own
+// sequence number plus an ack of the newest packet seen and a bitfield for the 32 before
+// it. Reliable messages get ids of their own and are delivered in id order; each is resent
+// on its own timer until a packet carrying it is acked, so one lost datagram costs one
+// retransmit rather than stalling everything behind it. PING/PONG go unreliably.
+#define NET_UDP_MAGIC 0x57
+#define NET_UDP_MAX_PACKET 1200
+#define NET_UDP_HEADER 11               // magic, kind, seq, ack, ack bits, has-ack
+#define NET_UDP_WINDOW 256              // reliable messages in flight; sent packets remembered
+#define NET_UDP_IDS_PER_PACKET 32
+#define NET_UDP_HEARTBEAT_MS 50         // acks and keepalive at least this often
+#define NET_UDP_TIMEOUT_MS 3000         // silence before the link counts as dropped
+#define NET_UDP_HELLO_MS 100
+#define NET_UDP_JOIN_TIMEOUT_MS 1000
+#define NET_UDP_MIN_RESEND_MS 30
+#define NET_UDP_DEFAULT_RESEND_MS 100   // until the first RTT sample
+enum { UDP_HELLO, UDP_WELCOME, UDP_DATA };
+typedef struct {
+    GameMessage message;
+    Uint32 lastSentAt; // 0 = not sent yet
+    bool isPending;
+} UdpReliable;
+typedef struct {
+    Uint16 seq;
+    bool isValid;
+    Uint8 count;
+    Uint16 ids[NET_UDP_IDS_PER_PACKET];
+} UdpSentPacket;
+static NetTransport s_transport = NET_TRANSPORT_TCP;
 static UDPsocket s_udpSocket = NULL;
 static UDPpacket *s_udpPacket = NULL;
-static Uint32 s_lastBroadcastTime = 0;
+static IPaddress s_udpPeer;
+static Uint32 s_udpNonce = 0; // picked by the joiner for each link attempt
+static bool s_isUdpLinked = false, s_isUdpLinkReady = false;
+static Uint32 s_udpLastHello = 0, s_udpLastRecv = 0, s_udpLastSend = 0;
+static Uint16 s_udpSendSeq = 0, s_udpRemoteSeq = 0;
+static Uint32 s_udpAckBits = 0;
+static bool s_udpHasRemote = false, s_udpNeedsAck = false;
+static UdpReliable s_udpOutbox[NET_UDP_WINDOW];  // by id % window
+static Uint16 s_udpNextId = 0, s_udpOldestId = 0;
+static UdpSentPacket s_udpSent[NET_UDP_WINDOW];  // by packet seq % window
+static GameMessage s_udpInbox[NET_UDP_WINDOW];   // out-of-order reliable messages
+static bool s_udpInboxFilled[NET_UDP_WINDOW];
+static Uint16 s_udpExpectedId = 0;
+static SDL_atomic_t s_udpResends, s_isUdpActive;
+
+// Impairment shim (network thread only). Decoded TCP messages and raw UDP datagrams wait
+// in a delay line until their simulated arrival time, so the game, the clock code and the
+// UDP reliability layer all see the impaired link.
+#define NET_SHIM_CAPACITY 256
+#define NET_SHIM_REORDER_HOLD_MS 20
+typedef struct {
+    Uint64 releaseAt;
+    Uint32 order;
+    int datagramLen; // 0 for a decoded TCP message
+    IPaddress from;
+    NetMessage message;
+    Uint8 datagram[NET_UDP_MAX_PACKET];
+} DelayedMessage;
+static NetImpairment s_impairment;
+static bool s_isImpaired = false;
+static DelayedMessage s_delayLine[NET_SHIM_CAPACITY];
+static int s_delayedCount = 0;
+static Uint32 s_delayedOrder = 0;
+static Uint64 s_linkFreeAt = 0, s_lastReleaseAt = 0;
+static Uint32 s_nextDropAt = 0, s_outageUntil = 0;
+static Uint32 s_shimRandom = 1;
+static SDL_atomic_t s_simulatedDisconnects, s_simulatedReorders, s_simulatedLosses;
+
+static bool NetQueue_Push(NetQueue *queue, const NetMessage *message) {
+    Uint32 tail = (Uint32)SDL_AtomicGet(&queue->tail);
+    Uint32 depth = tail - (Uint32)SDL_AtomicGet(&queue->head);
+    if (depth == NET_QUEUE_CAPACITY) return false;
+    queue->slots[tail & NET_QUEUE_MASK] = *message;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&queue->tail, (int)(tail + 1));
+    if ((int)depth + 1 > SDL_AtomicGet(&queue->maxDepth)) SDL_AtomicSet(&queue->maxDepth, (int)depth + 1);
+    return true;
+}
 
-static char s_netBuffer[1024] = {0};
-static int s_bufferLen = 0;
+static bool NetQueue_Pop(NetQueue *queue, NetMessage *message) {
+    Uint32 head = (Uint32)SDL_AtomicGet(&queue->head);
+    if (head == (Uint32)SDL_AtomicGet(&queue->tail)) return false;
+    SDL_MemoryBarrierAcquire();
+    *message = queue->slots[head & NET_QUEUE_MASK];
+    SDL_AtomicSet(&queue->head, (int)(head + 1));
+    return true;
+}
+
+static int NetQueue_Depth(NetQueue *queue) {
+    return (int)((Uint32)SDL_AtomicGet(&queue->tail) - (Uint32)SDL_AtomicGet(&queue->head));
+}
+
+static int Network_ThreadMain(void *unused);
+static int Network_SpectatorThreadMain(void *unused);
+static int Network_DiscoveryThreadMain(void *unused);
+static void Network_StartDiscovery(void);
 
 bool Network_Init(void) {
     if (SDLNet_Init() == -1) return false;
-    s_socketSet = SDLNet_AllocSocketSet(1);
+    s_discoveryLock = SDL_CreateMutex();
+    const char *netsim = getenv("WORDS_COLLIDE_NETSIM");
+    if (netsim) {
+        NetImpairment impairment = {0};
+        char key[32];
+        int value, used;
+        while (sscanf(netsim, "%31[^=]=%d%n", key, &value, &used) == 2) {
+            if (strcmp(key, "latency") == 0) impairment.latencyMs = value;
+            else if (strcmp(key, "jitter") == 0) impairment.jitterMs = value;
+            else if (strcmp(key, "kbps") == 0) impairment.bandwidthKbps = value;
+            else if (strcmp(key, "reorder") == 0) impairment.reorderPercent = value;
+            else if (strcmp(key, "loss") == 0) impairment.lossPercent = value;
+            else if (strcmp(key, "drop-every") == 0) impairment.disconnectEveryMs = value;
+            else if (strcmp(key, "drop-for") == 0) impairment.disconnectForMs = value;
+            else if (strcmp(key, "seed") == 0) impairment.seed = (unsigned)value;
+            netsim += used;
+            if (*netsim++ != ',') break;
+        }
+        Network_SetImpairment(&impairment);
+    }
+    s_clockAnchorUs = (Uint64)SDL_GetTicks() * 1000;
+    s_clockAnchorPerf = SDL_GetPerformanceCounter();
+    s_socketSet = SDLNet_AllocSocketSet(2); // the match's TCP socket and/or the UDP one
     return true;
 }
 
+void Network_SetImpairment(const NetImpairment *impairment) {
+    s_impairment = *impairment;
+    s_isImpaired = impairment->latencyMs > 0 || impairment->jitterMs > 0 || impairment->bandwidthKbps > 0 ||
+                   impairment->reorderPercent > 0 || impairment->lossPercent > 0 || impairment->disconnectEveryMs > 0;
+    s_shimRandom = impairment->seed ? impairment->seed : 1;
+    s_nextDropAt = 0;
+    if (s_isImpaired)
+        printf("Network: simulating %d+/-%d ms, %d kbps, %d%% reordered, %d%% lost, drop every %d ms for %d ms\n",
+               impairment->latencyMs, impairment->jitterMs, impairment->bandwidthKbps, impairment->reorderPercent,
+               impairment->lossPercent, impairment->disconnectEveryMs, impairment->disconnectForMs);
+}
+
+void Network_SetTransport(NetTransport transport) {
+    s_transport = transport;
+}
+
+static void Network_StartThread(void) {
+    if (s_thread) return;
+    SDL_AtomicSet(&s_threadRunning, 1);
+    s_thread = SDL_CreateThread(Network_ThreadMain, "NetworkIO", NULL);
+}
+
+static bool Network_SendRaw(const void *data, int len) {
+    if (!s_socket) return false;
+    Uint64 start = SDL_GetPerformanceCounter();
+    int result = SDLNet_TCP_Send(s_socket, data, len);
+    Uint64 elapsedUs = (SDL_GetPerformanceCounter() - start) * 1000000 / SDL_GetPerformanceFrequency();
+    SDL_AtomicAdd(&s_sendStallUs, (int)elapsedUs);
+    return (result == len);
+}
+
+// Whole seconds and the remainder are scaled apart: multiplying the raw count by a million
+// would overflow after about five hours of a 1 GHz counter.
+static Uint64 Network_ClockUs(Uint64 perfCounter) {
+    Uint64 elapsed = perfCounter - s_clockAnchorPerf, frequency = SDL_GetPerformanceFrequency();
+    return s_clockAnchorUs + elapsed / frequency * 1000000 + elapsed % frequency * 1000000 / frequency;
+}
+
+static void Network_UdpSendPacket(const GameMessage *unreliable);
+
+// For PING/PONG, which must not wait behind the outbound queue.
+static void Network_SendNow(const GameMessage *message) {
+    if (s_isUdpLinked) { Network_UdpSendPacket(message); return; }
+    Uint8 frame[PROTOCOL_MAX_FRAME];
+    Network_SendRaw(frame, Protocol_EncodeBinary(message, frame));
+}
+
+// Both sides announce their version as a text line, which v1 clients ignore. A peer
+// that understands v2 answers HELLO_ACK and everything it sends after that line is binary.
+static void Network_OnConnected(void) {
+    char hello[32];
+    if (s_serverSocket && s_sessionToken == 0) s_sessionToken = (Uint32)SDL_GetPerformanceCounter() | 1;
+    int len = sprintf(hello, "HELLO,%d,%u\n", PROTOCOL_VERSION, (unsigned)s_sessionToken);
+    s_sendBinary = false;
+    s_recvBinary = false;
+    s_sampleCount = 0;
+    s_lastPing = 0;
+    SDL_AtomicSet(&s_isClockSynced, s_serverSocket != NULL);
+    if (s_isUdpLinked) { s_sendBinary = s_recvBinary = true; return; } // UDP only speaks v2 frames
+    Network_SendRaw(hello, len);
+}
+
 bool Network_HostGame(int port) {
     IPaddress ip;
     if (SDLNet_ResolveHost(&ip, NULL, port) == -1) return false;
     s_serverSocket = SDLNet_TCP_Open(&ip);
     if (!s_serverSocket) return false;
+    if (!s_candidateSet) s_candidateSet = SDLNet_AllocSocketSet(NET_MAX_CANDIDATES);
+    Network_StartThread();
+    if (!s_spectatorThread) {
+        s_spectatorSet = SDLNet_AllocSocketSet(NET_MAX_SPECTATORS);
+        s_spectatorThread = SDL_CreateThread(Network_SpectatorThreadMain, "SpectatorIO", NULL);
+    }
+    // UDP players are taken on the same port number; spectators always come in over TCP.
+    if (!s_udpSocket && (s_udpSocket = SDLNet_UDP_Open(port)) != NULL) {
+        s_udpPacket = SDLNet_AllocPacket(NET_UDP_MAX_PACKET);
+        SDLNet_UDP_AddSocket(s_socketSet, s_udpSocket);
+    }
+    s_hostPort = port;
+    Network_SetHostInfo("", false);
+    SDL_AtomicSet(&s_isAnnouncing, 1);
+    Network_StartDiscovery();
     return true; 
 }
 
+// The connect itself stays synchronous so the join screen gets an immediate answer;
+// the socket is then handed over to the network thread.
+static bool Network_UdpJoin(const IPaddress *host);
+
 bool Network_JoinGame(const char* ipAddress, int port) {
     IPaddress ip;
     if (SDLNet_ResolveHost(&ip, ipAddress, port) == -1) return false;
-    s_socket = SDLNet_TCP_Open(&ip);
-    if (!s_socket) return false;
-    SDLNet_TCP_AddSocket(s_socketSet, s_socket);
-    s_isConnected = true;
+    if (s_transport == NET_TRANSPORT_UDP) {
+        if (!Network_UdpJoin(&ip)) return false;
+        s_peerAddress = ip;
+        s_hasPeerAddress = true;
+        Network_StartThread();
+        return true;
+    }
+    TCPsocket socket = SDLNet_TCP_Open(&ip);
+    if (!socket) return false;
+    s_peerAddress = ip;
+    s_hasPeerAddress = true;
+    SDL_AtomicSetPtr(&s_joinedSocket, socket);
+    Network_StartThread();
     return true;
 }
 
-bool Network_SendMessage(const char* msg) {
-    if (!s_isConnected || !s_socket) return false;
-    int len = strlen(msg);
-    int result = SDLNet_TCP_Send(s_socket, msg, len);
-    return (result == len);
+// Messages queued before the thread has picked up the connection go out once it has.
+bool Network_SendMessage(const GameMessage *message) {
+    if (!SDL_AtomicGet(&s_threadRunning) || SDL_AtomicGet(&s_isSpectating)) return false;
+    NetMessage queued = {*message, SDL_GetPerformanceCounter()};
+    if (NetQueue_Push(&s_outbound, &queued)) return true;
+    SDL_AtomicAdd(&s_outboundDropped, 1);
+    return false;
+}
+
+static void Network_Disconnect(void) {
+    if (s_socket) { SDLNet_TCP_DelSocket(s_socketSet, s_socket); SDLNet_TCP_Close(s_socket); }
+    s_socket = NULL;
+    s_readPos = s_scanPos = s_writePos = 0; // a partial frame from the old link is useless
+    s_delayedCount = 0;                     // nor is anything still "in flight" on it
+    s_linkFreeAt = s_lastReleaseAt = 0;
+    SDL_AtomicSet(&s_isConnected, 0);
+}
+
+bool Network_IsConnected(void) {
+    return SDL_AtomicGet(&s_isConnected) != 0;
+}
+
+int Network_GetLinkGeneration(void) {
+    return SDL_AtomicGet(&s_linkGeneration);
+}
+
+static TCPsocket Network_Redial(void) {
+    Uint32 now = SDL_GetTicks();
+    if (now - s_lastRedial < NET_REDIAL_INTERVAL_MS) return NULL;
+    s_lastRedial = now;
+    return SDLNet_TCP_Open(&s_peerAddress);
+}
+
+// Whatever the game queued while the link was down is superseded by the resync.
+static void Network_DropStaleOutbound(void) {
+    NetMessage stale;
+    int count = 0;
+    while (NetQueue_Pop(&s_outbound, &stale)) count++;
+    if (count > 0) printf("Network: discarded %d messages queued while disconnected\n", count);
+}
+
+// Everything queued since the last pass goes out in a single send.
+static void Network_UdpFlush(void);
+
+static void Network_FlushOutbound(void) {
+    static char batch[NET_QUEUE_CAPACITY * PROTOCOL_MAX_FRAME];
+    if (s_isUdpLinked) { Network_UdpFlush(); return; }
+    int len = 0, count = 0;
+    NetMessage queued;
+    while (len + PROTOCOL_MAX_FRAME <= (int)sizeof(batch) && NetQueue_Pop(&s_outbound, &queued)) {
+        if (s_sendBinary) len += Protocol_EncodeBinary(&queued.message, (Uint8 *)batch + len);
+        else len += Protocol_EncodeText(&queued.message, batch + len, PROTOCOL_MAX_FRAME);
+        count++;
+    }
+    if (count == 0) return;
+    if (!Network_SendRaw(batch, len)) { Network_Disconnect(); return; }
+    SDL_AtomicAdd(&s_messagesSent, count);
+    SDL_AtomicAdd(&s_sendBatches, 1);
+}
+
+// Drains everything the socket has ready straight into the ring's free space.
+static Uint64 Network_FillRing(void) {
+    Uint64 stamp = 0;
+    while (s_writePos - s_readPos < NET_RING_SIZE && SDLNet_CheckSockets(s_socketSet, 0) > 0 && SDLNet_SocketReady(s_socket)) {
+        Uint32 index = s_writePos & NET_RING_MASK;
+        Uint32 space = NET_RING_SIZE - (s_writePos - s_readPos);
+        if (space > NET_RING_SIZE - index) space = NET_RING_SIZE - index;
+        int result = SDLNet_TCP_Recv(s_socket, s_ring + index, space);
+        if (result <= 0) { Network_Disconnect(); break; }
+        s_writePos += result;
+        stamp = SDL_GetPerformanceCounter();
+    }
+    return stamp;
+}
+
+// Returns a contiguous view of [pos, pos + length], stitching a message that
+// straddles the wrap point into the scratch buffer.
+static const char *Network_RingView(Uint32 pos, int length) {
+    Uint32 start = pos & NET_RING_MASK;
+    if (start + length < NET_RING_SIZE) return s_ring + start;
+    int head = NET_RING_SIZE - start;
+    memcpy(s_wrapScratch, s_ring + start, head);
+    memcpy(s_wrapScratch + head, s_ring, length - head + 1);
+    return s_wrapScratch;
 }
 
-int Network_ReceiveMessage(char* buffer, int maxLen) {
-    if (s_serverSocket && !s_isConnected) {
-        s_socket = SDLNet_TCP_Accept(s_serverSocket);
-        if (s_socket) { SDLNet_TCP_AddSocket(s_socketSet, s_socket); s_isConnected = true; }
-        return 0; 
-    }
-    if (!s_isConnected || !s_socket) return 0;
-    if (SDLNet_CheckSockets(s_socketSet, 0) > 0) {
-        if (SDLNet_SocketReady(s_socket)) {
-            char temp[256];
-            int result = SDLNet_TCP_Recv(s_socket, temp, sizeof(temp) - 1);
-            if (result > 0) {
-                temp[result] = '\0';
-                if (s_bufferLen + result < sizeof(s_netBuffer)) { strcat(s_netBuffer, temp); s_bufferLen += result; }
+// Consumes HELLO / HELLO_ACK lines. Returns false for lines meant for the game.
+static bool Network_HandleHandshake(const char *line) {
+    int version = 0;
+    unsigned token = 0;
+    if (sscanf(line, "HELLO,%d,%u", &version, &token) >= 1) {
+        if (!s_serverSocket && token != 0) s_sessionToken = token;
+        if (version >= 2 && !s_sendBinary) {
+            Network_SendRaw("HELLO_ACK\n", 10);
+            s_sendBinary = true;
+        }
+        printf("Network: peer speaks protocol v%d, sending %s\n", version, s_sendBinary ? "binary" : "text");
+        return true;
+    }
+    if (strcmp(line, "HELLO_ACK") == 0) {
+        s_recvBinary = true;
+        return true;
+    }
+    // The host was already in a match: the rest of the stream is a binary spectator feed.
+    if (sscanf(line, "SPECTATE,%d", &version) == 1) {
+        s_recvBinary = true;
+        SDL_AtomicSet(&s_isSpectating, 1);
+        printf("Network: match already in progress, joined as a spectator\n");
+        return true;
+    }
+    return false;
+}
+
+// Pings only go to v2 peers, once a second, straight past the outbound queue.
+static void Network_MaybePing(void) {
+    Uint32 now = SDL_GetTicks();
+    if ((!s_socket && !s_isUdpLinked) || !s_sendBinary || now - s_lastPing < NET_PING_INTERVAL_MS) return;
+    s_lastPing = now;
+    GameMessage ping = {.type = MSG_PING};
+    Protocol_PutU64(ping.ping.t0, Network_ClockUs(SDL_GetPerformanceCounter()));
+    Network_SendNow(&ping);
+}
+
+// NTP arithmetic: rtt = (t3 - t0) - (t2 - t1), offset = ((t1 - t0) + (t2 - t3)) / 2.
+// RTT and jitter are smoothed like TCP's SRTT/RTTVAR; the clock offset is taken from the
+// lowest-RTT recent sample, since that one carries the least queueing asymmetry.
+static void Network_HandleTiming(const NetMessage *received) {
+    Sint64 arrivedUs = (Sint64)Network_ClockUs(received->receivedAt);
+    if (received->message.type == MSG_PING) {
+        GameMessage pong = {.type = MSG_PONG};
+        memcpy(pong.pong.t0, received->message.ping.t0, sizeof(pong.pong.t0));
+        Protocol_PutU64(pong.pong.t1, (Uint64)arrivedUs);
+        Protocol_PutU64(pong.pong.t2, Network_ClockUs(SDL_GetPerformanceCounter()));
+        Network_SendNow(&pong);
+        return;
+    }
+    const PongPayload *pong = &received->message.pong;
+    Sint64 t0 = (Sint64)Protocol_GetU64(pong->t0), t1 = (Sint64)Protocol_GetU64(pong->t1);
+    Sint64 t2 = (Sint64)Protocol_GetU64(pong->t2), t3 = arrivedUs;
+    Sint64 rtt = (t3 - t0) - (t2 - t1);
+    if (rtt < 0) rtt = 0;
+    if (s_sampleCount == 0) {
+        s_smoothedRttUs = (double)rtt;
+        s_rttVarianceUs = rtt / 2.0;
+    } else {
+        double error = s_smoothedRttUs - rtt;
+        s_rttVarianceUs = 0.75 * s_rttVarianceUs + 0.25 * (error < 0 ? -error : error);
+        s_smoothedRttUs = 0.875 * s_smoothedRttUs + 0.125 * rtt;
+    }
+    int slot = s_sampleCount++ % NET_CLOCK_SAMPLES;
+    s_sampleOffsetUs[slot] = ((t1 - t0) + (t2 - t3)) / 2;
+    s_sampleRttUs[slot] = rtt;
+    SDL_AtomicSet(&s_rttUs, (int)s_smoothedRttUs);
+    SDL_AtomicSet(&s_jitterUs, (int)s_rttVarianceUs);
+    if (s_serverSocket) return; // the host's clock is the shared one
+
+    int filled = s_sampleCount < NET_CLOCK_SAMPLES ? s_sampleCount : NET_CLOCK_SAMPLES, best = 0;
+    for (int i = 1; i < filled; i++) if (s_sampleRttUs[i] < s_sampleRttUs[best]) best = i;
+    SDL_AtomicSet(&s_clockOffsetMs, (int)(Uint32)(s_sampleOffsetUs[best] / 1000));
+    SDL_AtomicSet(&s_isClockSynced, 1);
+}
+
+Uint32 Network_LocalToSharedTicks(Uint32 localTicks) {
+    return localTicks + (Uint32)SDL_AtomicGet(&s_clockOffsetMs);
+}
+
+Uint32 Network_SharedToLocalTicks(Uint32 sharedTicks) {
+    return sharedTicks - (Uint32)SDL_AtomicGet(&s_clockOffsetMs);
+}
+
+bool Network_IsClockSynced(void) {
+    return SDL_AtomicGet(&s_isClockSynced) != 0;
+}
+
+static void Network_Deliver(const NetMessage *received) {
+    if (received->message.type == MSG_PING || received->message.type == MSG_PONG) Network_HandleTiming(received);
+    else NetQueue_Push(&s_inbound, received);
+}
+
+static Uint32 Network_ShimRandom(void) {
+    s_shimRandom ^= s_shimRandom << 13;
+    s_shimRandom ^= s_shimRandom >> 17;
+    s_shimRandom ^= s_shimRandom << 5;
+    return s_shimRandom;
+}
+
+// Bandwidth is modelled as serialisation delay on a single link, then latency and jitter
+// are added. Like TCP, nothing overtakes an earlier message unless picked for reordering.
+static DelayedMessage *Network_ShimHold(int bytes) {
+    Uint64 perMs = SDL_GetPerformanceFrequency() / 1000;
+    Uint64 arrival = SDL_GetPerformanceCounter();
+    if (s_impairment.bandwidthKbps > 0) {
+        if (s_linkFreeAt > arrival) arrival = s_linkFreeAt;
+        arrival += (Uint64)bytes * 8 * perMs / s_impairment.bandwidthKbps;
+        s_linkFreeAt = arrival;
+    }
+    int delayMs = s_impairment.latencyMs;
+    if (s_impairment.jitterMs > 0) delayMs += (int)(Network_ShimRandom() % (2 * s_impairment.jitterMs + 1)) - s_impairment.jitterMs;
+    if (delayMs < 0) delayMs = 0;
+    Uint64 releaseAt = arrival + (Uint64)delayMs * perMs;
+    if (s_impairment.reorderPercent > 0 && (int)(Network_ShimRandom() % 100) < s_impairment.reorderPercent) {
+        releaseAt += (Uint64)(s_impairment.jitterMs + NET_SHIM_REORDER_HOLD_MS) * perMs;
+        SDL_AtomicAdd(&s_simulatedReorders, 1);
+    } else {
+        if (releaseAt < s_lastReleaseAt) releaseAt = s_lastReleaseAt;
+        s_lastReleaseAt = releaseAt;
+    }
+    DelayedMessage *held = &s_delayLine[s_delayedCount++];
+    held->releaseAt = releaseAt;
+    held->order = s_delayedOrder++;
+    return held;
+}
+
+static void Network_ShimHoldMessage(const NetMessage *received) {
+    DelayedMessage *held = Network_ShimHold(Protocol_BinarySize(&received->message));
+    held->datagramLen = 0;
+    held->message = *received;
+}
+
+static void Network_ShimHoldDatagram(const UDPpacket *packet) {
+    if (s_delayedCount == NET_SHIM_CAPACITY) return; // a full router queue drops too
+    if (s_impairment.lossPercent > 0 && (int)(Network_ShimRandom() % 100) < s_impairment.lossPercent) {
+        SDL_AtomicAdd(&s_simulatedLosses, 1);
+        return;
+    }
+    DelayedMessage *held = Network_ShimHold(packet->len);
+    held->datagramLen = packet->len;
+    held->from = packet->address;
+    memcpy(held->datagram, packet->data, packet->len);
+}
+
+static void Network_UdpHandleDatagram(const Uint8 *data, int len, const IPaddress *from, Uint64 stamp);
+
+// Hands over every held message whose time has come, earliest first.
+static void Network_ShimRelease(void) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    while (s_delayedCount > 0 && NetQueue_Depth(&s_inbound) < NET_QUEUE_CAPACITY) {
+        int next = 0;
+        for (int i = 1; i < s_delayedCount; i++) {
+            const DelayedMessage *a = &s_delayLine[i], *b = &s_delayLine[next];
+            if (a->releaseAt < b->releaseAt || (a->releaseAt == b->releaseAt && a->order < b->order)) next = i;
+        }
+        if (s_delayLine[next].releaseAt > now) break;
+        if (s_delayLine[next].datagramLen > 0) {
+            DelayedMessage *released = &s_delayLine[next];
+            Network_UdpHandleDatagram(released->datagram, released->datagramLen, &released->from, now);
+            // Handling may have dropped the link and emptied the line.
+            if (next < s_delayedCount) s_delayLine[next] = s_delayLine[--s_delayedCount];
+            continue;
+        }
+        NetMessage released = s_delayLine[next].message;
+        released.receivedAt = now;
+        s_delayLine[next] = s_delayLine[--s_delayedCount];
+        Network_Deliver(&released);
+    }
+}
+
+static void Network_UdpDisconnect(void);
+
+static void Network_ShimMaybeDrop(void) {
+    if ((!s_socket && !s_isUdpLinked) || s_impairment.disconnectEveryMs <= 0) return;
+    Uint32 now = SDL_GetTicks();
+    if (s_nextDropAt == 0) s_nextDropAt = now + s_impairment.disconnectEveryMs;
+    if (now < s_nextDropAt) return;
+    printf("Network: simulated disconnect for %d ms\n", s_impairment.disconnectForMs);
+    if (s_isUdpLinked) Network_UdpDisconnect();
+    else Network_Disconnect();
+    s_outageUntil = now + s_impairment.disconnectForMs;
+    s_nextDropAt = s_outageUntil + s_impairment.disconnectEveryMs;
+    SDL_AtomicAdd(&s_simulatedDisconnects, 1);
+}
+
+// Frames and decodes whatever is in the ring. Stops early, leaving bytes in the
+// ring, if the game loop has fallen behind and the inbound queue is full.
+static void Network_ParseRing(Uint64 stamp) {
+    while (s_readPos != s_writePos) {
+        if (NetQueue_Depth(&s_inbound) == NET_QUEUE_CAPACITY || s_delayedCount == NET_SHIM_CAPACITY) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            SDL_Delay(1);
+            SDL_AtomicAdd(&s_inboundStallUs, (int)((SDL_GetPerformanceCounter() - start) * 1000000 / SDL_GetPerformanceFrequency()));
+            return;
+        }
+        NetMessage decoded = {.receivedAt = stamp};
+        bool isValid;
+        if (s_recvBinary) {
+            Uint32 available = s_writePos - s_readPos;
+            if (available < 2) return;
+            int bodyLen = ((Uint8)s_ring[s_readPos & NET_RING_MASK] << 8) | (Uint8)s_ring[(s_readPos + 1) & NET_RING_MASK];
+            if (bodyLen == 0 || bodyLen > PROTOCOL_MAX_FRAME) {
+                printf("WARNING: Bad %d-byte frame from peer, closing connection\n", bodyLen);
+                Network_Disconnect();
+                return;
             }
+            if (available < (Uint32)(2 + bodyLen)) return;
+            isValid = Protocol_DecodeBinary((const Uint8 *)Network_RingView(s_readPos + 2, bodyLen), bodyLen, &decoded.message);
+            s_scanPos = s_readPos = s_readPos + 2 + bodyLen;
+        } else {
+            if (s_scanPos == s_writePos) break;
+            Uint32 index = s_scanPos & NET_RING_MASK;
+            Uint32 span = s_writePos - s_scanPos;
+            if (span > NET_RING_SIZE - index) span = NET_RING_SIZE - index;
+            char *newline = memchr(s_ring + index, '\n', span);
+            if (!newline) { s_scanPos += span; continue; }
+
+            Uint32 lineEnd = s_scanPos + (Uint32)(newline - (s_ring + index));
+            *newline = '\0';
+            const char *line = Network_RingView(s_readPos, (int)(lineEnd - s_readPos));
+            s_scanPos = s_readPos = lineEnd + 1;
+            if (Network_HandleHandshake(line)) continue;
+            isValid = Protocol_DecodeText(line, &decoded.message);
         }
+        if (isValid && s_isImpaired) Network_ShimHoldMessage(&decoded);
+        else if (isValid) Network_Deliver(&decoded);
+        else printf("WARNING: Ignoring malformed network message\n");
     }
-    char* newline = strchr(s_netBuffer, '\n');
-    if (newline) {
-        *newline = '\0'; 
-        strncpy(buffer, s_netBuffer, maxLen - 1);
-        buffer[maxLen - 1] = '\0';
-        int msgLen = (newline - s_netBuffer) + 1;
-        int remaining = s_bufferLen - msgLen;
-        if (remaining > 0) { memmove(s_netBuffer, newline + 1, remaining); s_netBuffer[remaining] = '\0'; s_bufferLen = remaining; } 
-        else { s_netBuffer[0] = '\0'; s_bufferLen = 0; }
-        return strlen(buffer);
+
+    if (s_writePos - s_readPos == NET_RING_SIZE) {
+        printf("WARNING: Dropped %d-byte network line with no terminator\n", NET_RING_SIZE);
+        s_readPos = s_scanPos = s_writePos;
+    }
+}
+
+static void Network_PutU16(Uint8 *out, Uint16 value) {
+    out[0] = (Uint8)(value >> 8);
+    out[1] = (Uint8)value;
+}
+
+static Uint16 Network_GetU16(const Uint8 *in) {
+    return (Uint16)((in[0] << 8) | in[1]);
+}
+
+static bool Network_UdpIsPeer(const IPaddress *from) {
+    return from->host == s_udpPeer.host && from->port == s_udpPeer.port;
+}
+
+static void Network_UdpSendDatagram(const Uint8 *data, int len, const IPaddress *to) {
+    memcpy(s_udpPacket->data, data, len);
+    s_udpPacket->len = len;
+    s_udpPacket->address = *to;
+    SDLNet_UDP_Send(s_udpSocket, -1, s_udpPacket);
+}
+
+static void Network_UdpSendHandshake(int kind, const IPaddress *to) {
+    Uint8 packet[7] = {NET_UDP_MAGIC, (Uint8)kind};
+    Protocol_PutU32(packet + 2, s_udpNonce);
+    packet[6] = PROTOCOL_VERSION;
+    Network_UdpSendDatagram(packet, sizeof(packet), to);
+}
+
+// Anything unacked when a link drops is superseded by the game's own RESUME/RESYNC.
+static void Network_UdpDisconnect(void) {
+    if (s_isUdpLinked) printf("Network: UDP link to peer lost\n");
+    s_isUdpLinked = s_isUdpLinkReady = false;
+    s_udpSendSeq = s_udpRemoteSeq = 0;
+    s_udpAckBits = 0;
+    s_udpHasRemote = s_udpNeedsAck = false;
+    s_udpNextId = s_udpOldestId = s_udpExpectedId = 0;
+    memset(s_udpOutbox, 0, sizeof(s_udpOutbox));
+    memset(s_udpSent, 0, sizeof(s_udpSent));
+    memset(s_udpInboxFilled, 0, sizeof(s_udpInboxFilled));
+    s_delayedCount = 0;
+    s_linkFreeAt = s_lastReleaseAt = 0;
+    if (!s_serverSocket) s_udpNonce = (Uint32)SDL_GetPerformanceCounter() | 1;
+    SDL_AtomicSet(&s_isConnected, 0);
+}
+
+static void Network_UdpOnAck(Uint16 seq) {
+    UdpSentPacket *sent = &s_udpSent[seq % NET_UDP_WINDOW];
+    if (!sent->isValid || sent->seq != seq) return;
+    for (int i = 0; i < sent->count; i++) s_udpOutbox[sent->ids[i] % NET_UDP_WINDOW].isPending = false;
+    sent->isValid = false;
+}
+
+// Reliable messages are handed over strictly in id order, and only while the game loop
+// has room for them; anything else waits here.
+static void Network_UdpDrainInbox(void) {
+    while (s_udpInboxFilled[s_udpExpectedId % NET_UDP_WINDOW] && NetQueue_Depth(&s_inbound) < NET_QUEUE_CAPACITY) {
+        NetMessage received = {s_udpInbox[s_udpExpectedId % NET_UDP_WINDOW], SDL_GetPerformanceCounter()};
+        s_udpInboxFilled[s_udpExpectedId++ % NET_UDP_WINDOW] = false;
+        Network_Deliver(&received);
     }
+}
+
+static void Network_UdpHandleData(const Uint8 *data, int len, Uint64 stamp) {
+    if (len < NET_UDP_HEADER) return;
+    Uint16 seq = Network_GetU16(data + 2), ack = Network_GetU16(data + 4);
+    Uint32 ackBits = Protocol_GetU32(data + 6);
+    s_udpLastRecv = SDL_GetTicks();
+
+    // Bit i of our ack bits stands for packet (remoteSeq - 1 - i).
+    Uint16 behind = s_udpRemoteSeq - seq;
+    if (!s_udpHasRemote || (Sint16)behind < 0) {
+        Uint16 ahead = seq - s_udpRemoteSeq;
+        if (!s_udpHasRemote) s_udpAckBits = 0;
+        else if (ahead < 32) s_udpAckBits = (s_udpAckBits << ahead) | (1u << (ahead - 1));
+        else s_udpAckBits = (ahead == 32) ? 1u << 31 : 0;
+        s_udpRemoteSeq = seq;
+        s_udpHasRemote = true;
+    } else if (behind == 0 || (behind <= 32 && (s_udpAckBits & (1u << (behind - 1))))) {
+        return; // duplicate
+    } else if (behind <= 32) {
+        s_udpAckBits |= 1u << (behind - 1);
+    }
+    s_udpNeedsAck = true;
+
+    if (data[10]) {
+        Network_UdpOnAck(ack);
+        for (int i = 0; i < 32; i++) if (ackBits & (1u << i)) Network_UdpOnAck((Uint16)(ack - 1 - i));
+        while (s_udpOldestId != s_udpNextId && !s_udpOutbox[s_udpOldestId % NET_UDP_WINDOW].isPending) s_udpOldestId++;
+    }
+
+    int pos = NET_UDP_HEADER;
+    while (pos < len) {
+        bool isReliable = data[pos++] != 0;
+        Uint16 id = 0;
+        if (isReliable) {
+            if (pos + 2 > len) return;
+            id = Network_GetU16(data + pos);
+            pos += 2;
+        }
+        if (pos + 2 > len) return;
+        int bodyLen = Network_GetU16(data + pos);
+        if (bodyLen == 0 || pos + 2 + bodyLen > len) return;
+        NetMessage received = {.receivedAt = stamp};
+        bool isValid = Protocol_DecodeBinary(data + pos + 2, bodyLen, &received.message);
+        pos += 2 + bodyLen;
+        if (!isValid) continue;
+        if (!isReliable) { if (s_isUdpLinked) Network_Deliver(&received); continue; }
+        // Ids behind the expected one wrap to large distances: already delivered.
+        if ((Uint16)(id - s_udpExpectedId) >= NET_UDP_WINDOW) continue;
+        s_udpInbox[id % NET_UDP_WINDOW] = received.message;
+        s_udpInboxFilled[id % NET_UDP_WINDOW] = true;
+    }
+    if (s_isUdpLinked) Network_UdpDrainInbox();
+}
+
+// The host takes the first joiner to say HELLO; a HELLO with a new nonce from that same
+// joiner means it lost the link and is redialling. WELCOME is resent for duplicate HELLOs.
+static void Network_UdpHandleDatagram(const Uint8 *data, int len, const IPaddress *from, Uint64 stamp) {
+    if (len < 2 || data[0] != NET_UDP_MAGIC) return;
+    bool hasPeer = s_isUdpLinked || s_isUdpLinkReady;
+    if (data[1] == UDP_HELLO && len >= 7 && s_serverSocket && !s_socket) {
+        Uint32 nonce = Protocol_GetU32(data + 2);
+        if (hasPeer && !Network_UdpIsPeer(from)) return; // one player per match
+        if (!hasPeer || nonce != s_udpNonce) {
+            if (s_isUdpLinked) Network_UdpDisconnect();
+            s_udpPeer = *from;
+            s_udpNonce = nonce;
+            s_isUdpLinkReady = true;
+        }
+        Network_UdpSendHandshake(UDP_WELCOME, from);
+    } else if (data[1] == UDP_WELCOME && len >= 7 && !s_serverSocket) {
+        if (!s_isUdpLinked && Network_UdpIsPeer(from) && Protocol_GetU32(data + 2) == s_udpNonce) s_isUdpLinkReady = true;
+    } else if (data[1] == UDP_DATA && hasPeer && Network_UdpIsPeer(from)) {
+        // Before the network thread finishes linking, reliable messages wait in the inbox.
+        Network_UdpHandleData(data, len, stamp);
+    }
+}
+
+// Stops reading while the game loop is nearly full, like the TCP ring does.
+static void Network_UdpPoll(void) {
+    while (NetQueue_Depth(&s_inbound) < NET_QUEUE_CAPACITY - NET_UDP_IDS_PER_PACKET - 1 &&
+           SDLNet_UDP_Recv(s_udpSocket, s_udpPacket) > 0) {
+        if (s_isImpaired) Network_ShimHoldDatagram(s_udpPacket);
+        else Network_UdpHandleDatagram(s_udpPacket->data, s_udpPacket->len, &s_udpPacket->address, SDL_GetPerformanceCounter());
+    }
+    if (s_isUdpLinked) Network_UdpDrainInbox();
+}
+
+// Joiner side: keep saying HELLO until the host answers.
+static void Network_UdpListen(void) {
+    Uint32 now = SDL_GetTicks();
+    if (!s_serverSocket && now - s_udpLastHello >= NET_UDP_HELLO_MS) {
+        Network_UdpSendHandshake(UDP_HELLO, &s_udpPeer);
+        s_udpLastHello = now;
+    }
+    Network_UdpPoll();
+    if (s_isImpaired) Network_ShimRelease();
+}
+
+// Same contract as the TCP connect: the join screen hears straight away if nobody answers.
+static bool Network_UdpJoin(const IPaddress *host) {
+    if (!s_udpSocket) {
+        s_udpSocket = SDLNet_UDP_Open(0);
+        if (!s_udpSocket) return false;
+        s_udpPacket = SDLNet_AllocPacket(NET_UDP_MAX_PACKET);
+        SDLNet_UDP_AddSocket(s_socketSet, s_udpSocket);
+    }
+    s_udpPeer = *host;
+    s_udpNonce = (Uint32)SDL_GetPerformanceCounter() | 1;
+    s_udpLastHello = 0;
+    Uint32 start = SDL_GetTicks();
+    while (!s_isUdpLinkReady && SDL_GetTicks() - start < NET_UDP_JOIN_TIMEOUT_MS) {
+        Network_UdpListen();
+        SDL_Delay(5);
+    }
+    return s_isUdpLinkReady;
+}
+
+// One datagram: acks for what we have seen, every reliable message that is new or whose
+// resend timer has run out, and optionally one unreliable message. Pure acks and
+// keepalives go out when something arrived or the link has been quiet for a heartbeat.
+static void Network_UdpSendPacket(const GameMessage *unreliable) {
+    Uint8 packet[NET_UDP_MAX_PACKET];
+    Uint32 now = SDL_GetTicks();
+    Uint32 resendMs = NET_UDP_DEFAULT_RESEND_MS;
+    if (s_sampleCount > 0) resendMs = (Uint32)((s_smoothedRttUs + 4 * s_rttVarianceUs) / 1000);
+    if (resendMs < NET_UDP_MIN_RESEND_MS) resendMs = NET_UDP_MIN_RESEND_MS;
+
+    UdpSentPacket *sent = &s_udpSent[s_udpSendSeq % NET_UDP_WINDOW];
+    sent->count = 0;
+    int len = NET_UDP_HEADER;
+    for (Uint16 id = s_udpOldestId; id != s_udpNextId && sent->count < NET_UDP_IDS_PER_PACKET; id++) {
+        UdpReliable *slot = &s_udpOutbox[id % NET_UDP_WINDOW];
+        if (!slot->isPending || (slot->lastSentAt != 0 && now - slot->lastSentAt < resendMs)) continue;
+        if (len + 3 + Protocol_BinarySize(&slot->message) > NET_UDP_MAX_PACKET - PROTOCOL_MAX_FRAME) break;
+        packet[len++] = 1;
+        Network_PutU16(packet + len, id);
+        len += 2;
+        len += Protocol_EncodeBinary(&slot->message, packet + len);
+        if (slot->lastSentAt != 0) SDL_AtomicAdd(&s_udpResends, 1);
+        slot->lastSentAt = now;
+        sent->ids[sent->count++] = id;
+    }
+    if (unreliable) {
+        packet[len++] = 0;
+        len += Protocol_EncodeBinary(unreliable, packet + len);
+    }
+    if (sent->count == 0 && !unreliable && !s_udpNeedsAck && now - s_udpLastSend < NET_UDP_HEARTBEAT_MS) return;
+
+    packet[0] = NET_UDP_MAGIC;
+    packet[1] = UDP_DATA;
+    Network_PutU16(packet + 2, s_udpSendSeq);
+    Network_PutU16(packet + 4, s_udpRemoteSeq);
+    Protocol_PutU32(packet + 6, s_udpAckBits);
+    packet[10] = s_udpHasRemote;
+    sent->seq = s_udpSendSeq++;
+    sent->isValid = true;
+    Network_UdpSendDatagram(packet, len, &s_udpPeer);
+    s_udpLastSend = now;
+    s_udpNeedsAck = false;
+    if (sent->count > 0) SDL_AtomicAdd(&s_sendBatches, 1);
+}
+
+// Everything on the outbound queue is reliable. Ids are only handed out while the window
+// has room, so a peer that stops acking eventually backs up into the queue.
+static void Network_UdpFlush(void) {
+    NetMessage queued;
+    while ((Uint16)(s_udpNextId - s_udpOldestId) < NET_UDP_WINDOW && NetQueue_Pop(&s_outbound, &queued)) {
+        UdpReliable *slot = &s_udpOutbox[s_udpNextId++ % NET_UDP_WINDOW];
+        slot->message = queued.message;
+        slot->lastSentAt = 0;
+        slot->isPending = true;
+        SDL_AtomicAdd(&s_messagesSent, 1);
+    }
+    Network_UdpSendPacket(NULL);
+    if (SDL_GetTicks() - s_udpLastRecv > NET_UDP_TIMEOUT_MS) Network_UdpDisconnect();
+}
+
+static void Network_ServeAsSpectator(TCPsocket viewer) {
+    if (!s_spectatorThread || !SDL_AtomicCASPtr(&s_pendingSpectator, NULL, viewer)) SDLNet_TCP_Close(viewer);
+}
+
+// Anyone connecting while a match is running becomes a spectator.
+static void Network_AcceptSpectator(void) {
+    Uint32 now = SDL_GetTicks();
+    if (now - s_lastSpectatorAccept < NET_SPECTATOR_ACCEPT_MS) return;
+    s_lastSpectatorAccept = now;
+    TCPsocket viewer = SDLNet_TCP_Accept(s_serverSocket);
+    if (viewer) Network_ServeAsSpectator(viewer);
+}
+
+static TCPsocket Network_RemoveCandidate(int index) {
+    TCPsocket socket = s_candidates[index].socket;
+    SDLNet_TCP_DelSocket(s_candidateSet, socket);
+    s_candidates[index] = s_candidates[--s_candidateCount];
+    return socket;
+}
+
+// Once the match link is back, whoever is still waiting was not the player.
+static void Network_ReleaseCandidates(void) {
+    while (s_candidateCount > 0) Network_ServeAsSpectator(Network_RemoveCandidate(s_candidateCount - 1));
+}
+
+// Reads whatever the waiting newcomers have sent, without waiting. Returns the one whose
+// HELLO carries the session token; anyone with another first line, or none in time, is
+// served as a spectator instead.
+static TCPsocket Network_PollCandidates(void) {
+    if (s_candidateCount == 0 || SDLNet_CheckSockets(s_candidateSet, 0) < 0) return NULL;
+    Uint32 now = SDL_GetTicks();
+    for (int i = s_candidateCount - 1; i >= 0; i--) {
+        NetCandidate *candidate = &s_candidates[i];
+        if (SDLNet_SocketReady(candidate->socket)) {
+            int space = (int)sizeof(candidate->received) - 1 - candidate->len;
+            int result = SDLNet_TCP_Recv(candidate->socket, candidate->received + candidate->len, space);
+            if (result <= 0) { SDLNet_TCP_Close(Network_RemoveCandidate(i)); continue; }
+            candidate->len += result;
+            candidate->received[candidate->len] = '\0';
+        }
+        bool hasLine = memchr(candidate->received, '\n', candidate->len) != NULL;
+        int version = 0;
+        unsigned token = 0;
+        if (hasLine && sscanf(candidate->received, "HELLO,%d,%u", &version, &token) == 2 && token == s_sessionToken) {
+            // The ring is empty after a disconnect; the handshake and anything after it are read there.
+            memcpy(s_ring, candidate->received, candidate->len);
+            s_writePos = candidate->len;
+            return Network_RemoveCandidate(i);
+        }
+        bool isFull = candidate->len == (int)sizeof(candidate->received) - 1;
+        if (hasLine || isFull || now - candidate->acceptedAt > NET_RESUME_HELLO_MS) {
+            printf("Network: connection during the outage did not resume the match, serving it as a spectator\n");
+            Network_ServeAsSpectator(Network_RemoveCandidate(i));
+        }
+    }
+    return NULL;
+}
+
+// Before anyone has linked, the first connection is the player. After that a connection
+// made while the link is down only takes its place once its HELLO has been checked.
+static TCPsocket Network_AcceptPlayer(void) {
+    TCPsocket newcomer = SDLNet_TCP_Accept(s_serverSocket);
+    if (newcomer && s_sessionToken == 0) return newcomer;
+    if (newcomer && s_candidateCount == NET_MAX_CANDIDATES) {
+        Network_ServeAsSpectator(newcomer);
+    } else if (newcomer) {
+        s_candidates[s_candidateCount++] = (NetCandidate){.socket = newcomer, .acceptedAt = SDL_GetTicks()};
+        SDLNet_TCP_AddSocket(s_candidateSet, newcomer);
+    }
+    return Network_PollCandidates();
+}
+
+static int Network_ThreadMain(void *unused) {
+    while (SDL_AtomicGet(&s_threadRunning)) {
+        bool isLinked = s_socket || s_isUdpLinked;
+        if (!isLinked && (Sint32)(SDL_GetTicks() - s_outageUntil) < 0) { SDL_Delay(10); continue; }
+        if (!isLinked) {
+            s_socket = SDL_AtomicSetPtr(&s_joinedSocket, NULL);
+            if (!s_socket && s_udpSocket) Network_UdpListen();
+            if (!s_socket && s_serverSocket && !s_isUdpLinkReady) s_socket = Network_AcceptPlayer();
+            if (!s_socket && s_hasPeerAddress && s_transport == NET_TRANSPORT_TCP) s_socket = Network_Redial();
+            if (!s_socket && !s_isUdpLinkReady) { SDL_Delay(10); continue; }
+            if (SDL_AtomicGet(&s_linkGeneration) > 0) Network_DropStaleOutbound();
+            if (s_socket) {
+                SDLNet_TCP_AddSocket(s_socketSet, s_socket);
+            } else {
+                s_isUdpLinked = true;
+                s_isUdpLinkReady = false;
+                s_udpLastRecv = SDL_GetTicks();
+                SDL_AtomicSet(&s_isUdpActive, 1);
+                printf("Network: UDP link up\n");
+            }
+            Network_ReleaseCandidates();
+            Network_OnConnected();
+            SDL_AtomicSet(&s_isConnected, 1);
+            SDL_AtomicAdd(&s_linkGeneration, 1);
+        } else if (s_spectatorThread) {
+            Network_AcceptSpectator();
+        }
+        Network_FlushOutbound();
+        Network_MaybePing();
+        // The short wait bounds how long a freshly queued outbound message sits idle.
+        if (SDLNet_CheckSockets(s_socketSet, 2) > 0) {
+            if (s_udpSocket && SDLNet_SocketReady(s_udpSocket)) Network_UdpPoll();
+            if (s_socket && SDLNet_SocketReady(s_socket)) {
+                Uint64 stamp = Network_FillRing();
+                if (s_socket) Network_ParseRing(stamp ? stamp : SDL_GetPerformanceCounter());
+            }
+        } else if (s_socket && s_readPos != s_writePos) {
+            Network_ParseRing(SDL_GetPerformanceCounter());
+        }
+        if (s_isImpaired) {
+            Network_ShimRelease();
+            Network_ShimMaybeDrop();
+        }
+    }
+    return 0;
+}
+
+// The sender closes the socket and frees the viewer once any send in progress returns.
+static void Network_DropSpectator(int index) {
+    Spectator *viewer = s_spectators[index];
+    SDLNet_TCP_DelSocket(s_spectatorSet, viewer->socket);
+    SDL_LockMutex(viewer->lock);
+    viewer->isClosing = true;
+    SDL_CondSignal(viewer->wake);
+    SDL_UnlockMutex(viewer->lock);
+    s_spectators[index] = s_spectators[--s_spectatorCount];
+}
+
+static int Network_SpectatorSenderMain(void *data) {
+    Spectator *viewer = data;
+    SDL_LockMutex(viewer->lock);
+    while (!viewer->isClosing) {
+        if (viewer->head == viewer->tail || viewer->hasFailed) {
+            SDL_CondWait(viewer->wake, viewer->lock);
+            continue;
+        }
+        Uint32 start = viewer->tail % NET_SPECTATOR_QUEUE_BYTES;
+        int len = (int)(viewer->head - viewer->tail);
+        if (len > NET_SPECTATOR_QUEUE_BYTES - (int)start) len = NET_SPECTATOR_QUEUE_BYTES - (int)start;
+        if (len > NET_SPECTATOR_SEND_CHUNK) len = NET_SPECTATOR_SEND_CHUNK;
+        SDL_UnlockMutex(viewer->lock);
+        bool isSent = SDLNet_TCP_Send(viewer->socket, viewer->queue + start, len) == len;
+        SDL_LockMutex(viewer->lock);
+        viewer->tail += len;
+        viewer->lastProgressAt = SDL_GetTicks();
+        if (!isSent) viewer->hasFailed = true;
+    }
+    SDL_UnlockMutex(viewer->lock);
+    SDLNet_TCP_Close(viewer->socket);
+    SDL_DestroyCond(viewer->wake);
+    SDL_DestroyMutex(viewer->lock);
+    free(viewer);
+    return 0;
+}
+
+// Never blocks. Returns false, queueing nothing, when the bytes do not fit.
+static bool Network_QueueForSpectator(Spectator *viewer, const void *data, int len) {
+    SDL_LockMutex(viewer->lock);
+    bool fits = viewer->head - viewer->tail + (Uint32)len <= NET_SPECTATOR_QUEUE_BYTES;
+    if (fits) {
+        if (viewer->head == viewer->tail) viewer->lastProgressAt = SDL_GetTicks();
+        for (int copied = 0; copied < len;) {
+            Uint32 start = viewer->head % NET_SPECTATOR_QUEUE_BYTES;
+            int chunk = len - copied;
+            if (chunk > NET_SPECTATOR_QUEUE_BYTES - (int)start) chunk = NET_SPECTATOR_QUEUE_BYTES - (int)start;
+            memcpy(viewer->queue + start, (const Uint8 *)data + copied, chunk);
+            viewer->head += chunk;
+            copied += chunk;
+        }
+        SDL_CondSignal(viewer->wake);
+    }
+    SDL_UnlockMutex(viewer->lock);
+    return fits;
+}
+
+static bool Network_IsSpectatorGone(Spectator *viewer) {
+    SDL_LockMutex(viewer->lock);
+    bool isStuck = viewer->head != viewer->tail && SDL_GetTicks() - viewer->lastProgressAt > NET_SPECTATOR_TIMEOUT_MS;
+    bool isGone = viewer->hasFailed || isStuck;
+    SDL_UnlockMutex(viewer->lock);
+    return isGone;
+}
+
+static void Network_AddSpectator(TCPsocket socket) {
+    char header[32];
+    int len = sprintf(header, "SPECTATE,%d\n", PROTOCOL_VERSION);
+    Spectator *viewer = s_spectatorCount < NET_MAX_SPECTATORS ? calloc(1, sizeof(Spectator)) : NULL;
+    SDL_Thread *sender = NULL;
+    if (viewer) {
+        viewer->socket = socket;
+        viewer->lock = SDL_CreateMutex();
+        viewer->wake = SDL_CreateCond();
+        viewer->needsSnapshot = true;
+        if (viewer->lock && viewer->wake && Network_QueueForSpectator(viewer, header, len))
+            sender = SDL_CreateThread(Network_SpectatorSenderMain, "SpectatorSend", viewer);
+    }
+    if (!sender) {
+        if (viewer && viewer->wake) SDL_DestroyCond(viewer->wake);
+        if (viewer && viewer->lock) SDL_DestroyMutex(viewer->lock);
+        free(viewer);
+        SDLNet_TCP_Close(socket);
+        return;
+    }
+    SDL_DetachThread(sender); // never joined: a viewer that stopped reading can hold it in a send
+    SDLNet_TCP_AddSocket(s_spectatorSet, socket);
+    s_spectators[s_spectatorCount++] = viewer;
+    s_spectatorsServed++;
+}
+
+// Keeps the thread's copy of the match current so late joiners can be sent a snapshot.
+static void Network_ApplyToView(const GameMessage *update) {
+    Uint32 now = SDL_GetTicks();
+    switch (update->type) {
+        case MSG_SNAPSHOT:
+            s_view = update->snapshot;
+            s_viewGameStart = now - Protocol_GetU32(s_view.gameElapsedMs);
+            s_viewTurnStart = now - Protocol_GetU32(s_view.turnElapsedMs);
+            s_hasView = true;
+            break;
+        case MSG_STATE:
+            s_view.grid[update->state.x][update->state.y] = update->state.letter;
+            memcpy(s_view.scores, update->state.scores, sizeof(s_view.scores));
+            s_view.currentPlayer = update->state.nextPlayer;
+            // Only the host keeps a view, and its clock is the shared one.
+            s_viewTurnStart = Protocol_GetU32(update->state.turnStartMs) ? Protocol_GetU32(update->state.turnStartMs) : now;
+            break;
+        case MSG_PAUSE_ON: s_view.isPaused = 1; break;
+        case MSG_PAUSE_OFF: s_view.isPaused = 0; break;
+        default: break;
+    }
+}
+
+static int Network_SpectatorThreadMain(void *unused) {
+    static Uint8 deltas[NET_QUEUE_CAPACITY * PROTOCOL_MAX_FRAME];
+    Uint8 snapshot[PROTOCOL_MAX_FRAME];
+    char discard[256];
+    while (SDL_AtomicGet(&s_threadRunning)) {
+        TCPsocket joined = SDL_AtomicSetPtr(&s_pendingSpectator, NULL);
+        if (joined) Network_AddSpectator(joined);
+
+        // Spectators never send anything we use; reading only tells us they left.
+        if (s_spectatorCount > 0 && SDLNet_CheckSockets(s_spectatorSet, 0) > 0) {
+            for (int i = s_spectatorCount - 1; i >= 0; i--) {
+                if (SDLNet_SocketReady(s_spectators[i]->socket) && SDLNet_TCP_Recv(s_spectators[i]->socket, discard, sizeof(discard)) <= 0)
+                    Network_DropSpectator(i);
+            }
+        }
+
+        int deltaLen = 0, snapshotLen = 0;
+        bool resyncAll = false;
+        NetMessage update;
+        while (deltaLen + PROTOCOL_MAX_FRAME <= (int)sizeof(deltas) && NetQueue_Pop(&s_spectatorUpdates, &update)) {
+            Network_ApplyToView(&update.message);
+            if (update.message.type == MSG_SNAPSHOT) { resyncAll = true; deltaLen = 0; continue; }
+            deltaLen += Protocol_EncodeBinary(&update.message, deltas + deltaLen);
+            s_fanOutEncodes++;
+        }
+        if (deltaLen > 0 || resyncAll) s_fanOutBatches++;
+
+        Uint32 now = SDL_GetTicks();
+        for (int i = s_spectatorCount - 1; i >= 0; i--) {
+            Spectator *viewer = s_spectators[i];
+            if (Network_IsSpectatorGone(viewer)) { Network_DropSpectator(i); s_spectatorsDropped++; continue; }
+            if (resyncAll) viewer->needsSnapshot = true;
+            if (viewer->needsSnapshot) {
+                if (!s_hasView || now - viewer->lastSnapshotAt < NET_SPECTATOR_RESYNC_MS) continue;
+                if (snapshotLen == 0) {
+                    GameMessage message = {.type = MSG_SNAPSHOT, .snapshot = s_view};
+                    Protocol_PutU32(message.snapshot.gameElapsedMs, now - s_viewGameStart);
+                    Protocol_PutU32(message.snapshot.turnElapsedMs, now - s_viewTurnStart);
+                    snapshotLen = Protocol_EncodeBinary(&message, snapshot);
+                    s_fanOutEncodes++;
+                }
+                if (!Network_QueueForSpectator(viewer, snapshot, snapshotLen)) continue; // still backed up
+                if (viewer->lastSnapshotAt) s_spectatorResyncs++;
+                viewer->needsSnapshot = false;
+                viewer->lastSnapshotAt = now;
+                s_fanOutSends++;
+            } else if (deltaLen > 0) {
+                // Downsampled: a viewer too far behind for these deltas waits for a snapshot.
+                if (Network_QueueForSpectator(viewer, deltas, deltaLen)) s_fanOutSends++;
+                else viewer->needsSnapshot = true;
+            }
+        }
+        if (deltaLen == 0 && !resyncAll) SDL_Delay(5);
+    }
+    while (s_spectatorCount > 0) Network_DropSpectator(s_spectatorCount - 1);
     return 0;
 }
 
+// Host only; the game loop calls this after applying each change to its own state.
+bool Network_PublishSpectatorUpdate(const GameMessage *message) {
+    if (!s_spectatorThread) return false;
+    NetMessage queued = {*message, SDL_GetPerformanceCounter()};
+    return NetQueue_Push(&s_spectatorUpdates, &queued);
+}
+
+int Network_ReceiveMessages(NetMessage *messages, int maxMessages) {
+    int count = 0;
+    while (count < maxMessages && NetQueue_Pop(&s_inbound, &messages[count])) count++;
+    if (count > s_maxBurst) s_maxBurst = count;
+    return count;
+}
+
+void Network_MarkApplied(const NetMessage *message) {
+    Uint64 latency = SDL_GetPerformanceCounter() - message->receivedAt;
+    s_latencyTotal += latency;
+    if (latency > s_latencyMax) s_latencyMax = latency;
+    s_appliedCount++;
+}
+
+void Network_GetStats(NetworkStats *stats) {
+    stats->inboundDepth = NetQueue_Depth(&s_inbound);
+    stats->inboundMaxDepth = SDL_AtomicGet(&s_inbound.maxDepth);
+    stats->outboundDepth = NetQueue_Depth(&s_outbound);
+    stats->outboundMaxDepth = SDL_AtomicGet(&s_outbound.maxDepth);
+    stats->outboundDropped = SDL_AtomicGet(&s_outboundDropped);
+    stats->messagesSent = SDL_AtomicGet(&s_messagesSent);
+    stats->sendBatches = SDL_AtomicGet(&s_sendBatches);
+    stats->sendStallMs = SDL_AtomicGet(&s_sendStallUs) / 1000.0;
+    stats->inboundStallMs = SDL_AtomicGet(&s_inboundStallUs) / 1000.0;
+    stats->rttMs = SDL_AtomicGet(&s_rttUs) / 1000.0;
+    stats->jitterMs = SDL_AtomicGet(&s_jitterUs) / 1000.0;
+    stats->clockOffsetMs = SDL_AtomicGet(&s_clockOffsetMs);
+    stats->isClockSynced = SDL_AtomicGet(&s_isClockSynced) != 0;
+    stats->isUdp = s_transport == NET_TRANSPORT_UDP || SDL_AtomicGet(&s_isUdpActive);
+    stats->reliableResends = SDL_AtomicGet(&s_udpResends);
+    stats->simulatedDisconnects = SDL_AtomicGet(&s_simulatedDisconnects);
+    stats->simulatedReorders = SDL_AtomicGet(&s_simulatedReorders);
+    stats->simulatedLosses = SDL_AtomicGet(&s_simulatedLosses);
+}
+
 void Network_Cleanup(void) {
+    if (s_thread) {
+        SDL_AtomicSet(&s_threadRunning, 0);
+        SDL_WaitThread(s_thread, NULL);
+        s_thread = NULL;
+    }
+    if (s_spectatorThread) {
+        SDL_WaitThread(s_spectatorThread, NULL);
+        s_spectatorThread = NULL;
+        printf("Network: %d spectators served, %d updates encoded once for %d sends in %d fan-out passes, %d resyncs, %d dropped\n",
+               s_spectatorsServed, s_fanOutEncodes, s_fanOutSends, s_fanOutBatches, s_spectatorResyncs, s_spectatorsDropped);
+    }
+    if (s_pendingSpectator) SDLNet_TCP_Close(SDL_AtomicSetPtr(&s_pendingSpectator, NULL));
+    while (s_candidateCount > 0) SDLNet_TCP_Close(Network_RemoveCandidate(s_candidateCount - 1));
+    if (s_appliedCount > 0) {
+        NetworkStats stats;
+        Network_GetStats(&stats);
+        double toMs = 1000.0 / SDL_GetPerformanceFrequency();
+        printf("Network: %llu messages applied, largest burst %d/frame, recv-to-apply avg %.3f ms, max %.3f ms\n",
+               (unsigned long long)s_appliedCount, s_maxBurst, s_latencyTotal * toMs / s_appliedCount, s_latencyMax * toMs);
+        printf("Network: %d sent in %d batches, queue max depth in/out %d/%d, stalls send %.1f ms / inbound %.1f ms, %d dropped\n",
+               stats.messagesSent, stats.sendBatches, stats.inboundMaxDepth, stats.outboundMaxDepth,
+               stats.sendStallMs, stats.inboundStallMs, stats.outboundDropped);
+    }
     if (s_socket) SDLNet_TCP_Close(s_socket);
     if (s_serverSocket) SDLNet_TCP_Close(s_serverSocket);
     if (s_socketSet) SDLNet_FreeSocketSet(s_socketSet);
+    if (s_spectatorSet) SDLNet_FreeSocketSet(s_spectatorSet);
+    if (s_candidateSet) SDLNet_FreeSocketSet(s_candidateSet);
     if (s_udpSocket) SDLNet_UDP_Close(s_udpSocket);
     if (s_udpPacket) SDLNet_FreePacket(s_udpPacket);
+    if (s_discoveryThread) {
+        SDL_AtomicSet(&s_discoveryRunning, 0);
+        SDL_WaitThread(s_discoveryThread, NULL);
+        s_discoveryThread = NULL;
+    }
+    if (s_discoveryLock) SDL_DestroyMutex(s_discoveryLock);
     SDLNet_Quit();
 }
 
+// Resolved once; the waiting screen asks for it every frame.
 const char* Network_GetLocalIP() {
     static char ipBuffer[64] = "127.0.0.1"; 
+    static bool isResolved = false;
+    if (isResolved) return ipBuffer;
+    isResolved = true;
 #ifdef _WIN32
     char hostname[256];
     if (gethostname(hostname, sizeof(hostname)) == 0) {
@@ -103,26 +1340,148 @@ const char* Network_GetLocalIP() {
     return ipBuffer;
 }
 
-void Network_BroadcastPresence(const char* hostName) {
-    if (!s_udpSocket) { s_udpSocket = SDLNet_UDP_Open(0); s_udpPacket = SDLNet_AllocPacket(512); }
-    Uint32 currentTime = SDL_GetTicks();
-    if (currentTime - s_lastBroadcastTime > 1000) { 
-        IPaddress ip; SDLNet_ResolveHost(&ip, "255.255.255.255", 8888); 
-        s_udpPacket->address.host = ip.host; s_udpPacket->address.port = ip.port;
-        sprintf((char*)s_udpPacket->data, "WORDS_COLLIDE,%s,%s", Network_GetLocalIP(), hostName);
-        s_udpPacket->len = strlen((char*)s_udpPacket->data);
-        SDLNet_UDP_Send(s_udpSocket, -1, s_udpPacket); s_lastBroadcastTime = currentTime;
+static void Network_StartDiscovery(void) {
+    if (s_discoveryThread) return;
+    s_discoverySet = SDLNet_AllocSocketSet(2);
+    SDL_AtomicSet(&s_discoveryRunning, 1);
+    s_discoveryThread = SDL_CreateThread(Network_DiscoveryThreadMain, "Discovery", NULL);
+}
+
+// Host only. Called when the host's name is entered and when its match starts, never per frame.
+void Network_SetHostInfo(const char *hostName, bool isInMatch) {
+    SDL_LockMutex(s_discoveryLock);
+    s_announcementLen = snprintf(s_announcement, sizeof(s_announcement), "WORDS_COLLIDE,%d,%d,%s",
+                                 s_hostPort, isInMatch ? 1 : 0, hostName);
+    SDL_UnlockMutex(s_discoveryLock);
+}
+
+void Network_StartBrowsing(void) {
+    SDL_LockMutex(s_discoveryLock);
+    s_hostCount = 0;
+    s_browseStartedAt = SDL_GetTicks();
+    s_hasFoundHost = false;
+    SDL_UnlockMutex(s_discoveryLock);
+    SDL_AtomicSet(&s_probeRequested, 1);
+    SDL_AtomicSet(&s_isBrowsing, 1);
+    Network_StartDiscovery();
+}
+
+void Network_StopBrowsing(void) {
+    SDL_AtomicSet(&s_isBrowsing, 0);
+}
+
+int Network_GetDiscoveredHosts(DiscoveredHost *hosts, int maxHosts) {
+    SDL_LockMutex(s_discoveryLock);
+    int count = s_hostCount < maxHosts ? s_hostCount : maxHosts;
+    memcpy(hosts, s_hosts, count * sizeof(DiscoveredHost));
+    SDL_UnlockMutex(s_discoveryLock);
+    return count;
+}
+
+// Sockets are only opened and closed here, so the thread never waits on a set the game loop is changing.
+static void Network_UpdateDiscoverySockets(void) {
+    if (SDL_AtomicGet(&s_isAnnouncing) && !s_announceSocket) {
+        s_announceSocket = SDLNet_UDP_Open(NET_DISCOVERY_PORT);
+        if (s_announceSocket) SDLNet_UDP_AddSocket(s_discoverySet, s_announceSocket);
+        else printf("Network: discovery port %d is taken, this host can only be joined by IP\n", NET_DISCOVERY_PORT);
+        SDL_AtomicSet(&s_isAnnouncing, s_announceSocket != NULL);
+    }
+    bool isBrowsing = SDL_AtomicGet(&s_isBrowsing);
+    if (isBrowsing && !s_probeSocket) {
+        s_probeSocket = SDLNet_UDP_Open(0);
+        if (s_probeSocket) SDLNet_UDP_AddSocket(s_discoverySet, s_probeSocket);
+    } else if (!isBrowsing && s_probeSocket) {
+        SDLNet_UDP_DelSocket(s_discoverySet, s_probeSocket);
+        SDLNet_UDP_Close(s_probeSocket);
+        s_probeSocket = NULL;
+    }
+}
+
+static void Network_AnswerProbe(UDPpacket *packet) {
+    int probeLen = (int)sizeof(NET_DISCOVERY_PROBE) - 1;
+    if (packet->len != probeLen || memcmp(packet->data, NET_DISCOVERY_PROBE, probeLen) != 0) return;
+    SDL_LockMutex(s_discoveryLock);
+    memcpy(packet->data, s_announcement, s_announcementLen);
+    packet->len = s_announcementLen;
+    SDL_UnlockMutex(s_discoveryLock);
+    SDLNet_UDP_Send(s_announceSocket, -1, packet); // straight back to the prober
+}
+
+static void Network_AddDiscoveredHost(UDPpacket *packet, Uint32 now) {
+    int port = 0, isInMatch = 0;
+    char name[MAX_NAME_LENGTH] = "";
+    if (packet->len >= packet->maxlen) return;
+    packet->data[packet->len] = '\0';
+    if (sscanf((char*)packet->data, "WORDS_COLLIDE,%d,%d,%15[^\n]", &port, &isInMatch, name) < 2) return;
+
+    // The host's address is where the answer came from, so hosts never have to look it up.
+    const Uint8 *octets = (const Uint8*)&packet->address.host;
+    char ip[16];
+    sprintf(ip, "%d.%d.%d.%d", octets[0], octets[1], octets[2], octets[3]);
+
+    SDL_LockMutex(s_discoveryLock);
+    int index = 0;
+    while (index < s_hostCount && (strcmp(s_hosts[index].ip, ip) != 0 || s_hosts[index].port != port)) index++;
+    if (index < NET_MAX_DISCOVERED_HOSTS) {
+        DiscoveredHost *host = &s_hosts[index];
+        if (index == s_hostCount) s_hostCount++;
+        strcpy(host->ip, ip);
+        host->port = port;
+        host->isInMatch = isInMatch != 0;
+        snprintf(host->label, sizeof(host->label), "%s  -  %s%s", name[0] ? name : "Unnamed host", ip,
+                 host->isInMatch ? "  (playing, join to watch)" : "");
+        s_hostSeenAt[index] = now;
+        if (!s_hasFoundHost) {
+            s_hasFoundHost = true;
+            printf("Network: found host %s %u ms after browsing started\n", ip, now - s_browseStartedAt);
+        }
+    }
+    SDL_UnlockMutex(s_discoveryLock);
+}
+
+static void Network_ExpireHosts(Uint32 now) {
+    SDL_LockMutex(s_discoveryLock);
+    for (int i = s_hostCount - 1; i >= 0; i--) {
+        if (now - s_hostSeenAt[i] <= NET_HOST_TTL_MS) continue;
+        memmove(&s_hosts[i], &s_hosts[i + 1], (s_hostCount - i - 1) * sizeof(DiscoveredHost));
+        memmove(&s_hostSeenAt[i], &s_hostSeenAt[i + 1], (s_hostCount - i - 1) * sizeof(Uint32));
+        s_hostCount--;
     }
+    SDL_UnlockMutex(s_discoveryLock);
 }
 
-bool Network_ListenForHost(char* foundIP) {
-    if (!s_udpSocket) { s_udpSocket = SDLNet_UDP_Open(8888); s_udpPacket = SDLNet_AllocPacket(512); }
-    if (SDLNet_UDP_Recv(s_udpSocket, s_udpPacket)) {
-        char* data = (char*)s_udpPacket->data; data[s_udpPacket->len] = '\0';
-        if (strncmp(data, "WORDS_COLLIDE", 13) == 0) {
-            char header[32], ip[64], name[64];
-            sscanf(data, "%[^,],%[^,],%[^\n]", header, ip, name); strcpy(foundIP, ip); return true;
+static int Network_DiscoveryThreadMain(void *unused) {
+    UDPpacket *packet = SDLNet_AllocPacket(NET_DISCOVERY_PACKET_SIZE);
+    IPaddress broadcast;
+    SDLNet_ResolveHost(&broadcast, "255.255.255.255", NET_DISCOVERY_PORT);
+    Uint32 lastProbe = 0;
+    while (SDL_AtomicGet(&s_discoveryRunning)) {
+        Network_UpdateDiscoverySockets();
+        Uint32 now = SDL_GetTicks();
+        if (s_probeSocket && (SDL_AtomicSet(&s_probeRequested, 0) || now - lastProbe >= NET_PROBE_INTERVAL_MS)) {
+            packet->address = broadcast;
+            packet->len = (int)sizeof(NET_DISCOVERY_PROBE) - 1;
+            memcpy(packet->data, NET_DISCOVERY_PROBE, packet->len);
+            SDLNet_UDP_Send(s_probeSocket, -1, packet);
+            lastProbe = now;
+        }
+
+        if (!s_announceSocket && !s_probeSocket) { SDL_Delay(10); continue; }
+        if (SDLNet_CheckSockets(s_discoverySet, 10) > 0) {
+            now = SDL_GetTicks();
+            if (s_announceSocket && SDLNet_SocketReady(s_announceSocket)) {
+                while (SDLNet_UDP_Recv(s_announceSocket, packet) > 0) Network_AnswerProbe(packet);
+            }
+            if (s_probeSocket && SDLNet_SocketReady(s_probeSocket)) {
+                while (SDLNet_UDP_Recv(s_probeSocket, packet) > 0) Network_AddDiscoveredHost(packet, now);
+            }
         }
+        if (s_probeSocket) Network_ExpireHosts(SDL_GetTicks());
     }
-    return false;
-}
\ No newline at end of file
+    if (s_announceSocket) SDLNet_UDP_Close(s_announceSocket);
+    if (s_probeSocket) SDLNet_UDP_Close(s_probeSocket);
+    s_announceSocket = s_probeSocket = NULL;
+    SDLNet_FreeSocketSet(s_discoverySet);
+    SDLNet_FreePacket(packet);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "../include/profiler.h"
+
+#if PROFILER_ENABLED
+
+// The game thread times events, simulation and network while the render thread times
+// rendering and closes frames, so accumulators are atomics (phase times in microseconds).
+// Each phase is only ever begun and ended by one thread.
+static Uint64 phaseStartedAt[PROFILE_PHASE_COUNT];
+static SDL_atomic_t phaseUs[PROFILE_PHASE_COUNT];
+static SDL_atomic_t counters[PROFILE_COUNTER_COUNT];
+static SDL_atomic_t isOverlayVisible;
+static Uint64 lastFrameEndedAt;
+static ProfileSnapshot snapshot = {.newest = PROFILE_HISTORY - 1};
+
+void Profiler_BeginPhase(ProfilePhase phase) {
+    phaseStartedAt[phase] = SDL_GetPerformanceCounter();
+}
+
+void Profiler_EndPhase(ProfilePhase phase) {
+    Uint64 elapsed = SDL_GetPerformanceCounter() - phaseStartedAt[phase];
+    SDL_AtomicAdd(&phaseUs[phase], (int)(elapsed * 1000000 / SDL_GetPerformanceFrequency()));
+}
+
+void Profiler_Add(ProfileCounter counter, int amount) {
+    SDL_AtomicAdd(&counters[counter], amount);
+}
+
+void Profiler_EndFrame(void) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    if (lastFrameEndedAt == 0) lastFrameEndedAt = now;
+    snapshot.newest = (snapshot.newest + 1) % PROFILE_HISTORY;
+    snapshot.frameMs[snapshot.newest] = (float)((now - lastFrameEndedAt) * 1000.0 / frequency);
+    lastFrameEndedAt = now;
+
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+        snapshot.phaseMs[i] = SDL_AtomicSet(&phaseUs[i], 0) / 1000.0f;
+    for (int i = 0; i < PROFILE_COUNTER_COUNT; i++)
+        snapshot.counters[i] = SDL_AtomicSet(&counters[i], 0);
+}
+
+void Profiler_ToggleOverlay(void) {
+    SDL_AtomicSet(&isOverlayVisible, !SDL_AtomicGet(&isOverlayVisible));
+}
+
+bool Profiler_IsOverlayVisible(void) {
+    return SDL_AtomicGet(&isOverlayVisible) != 0;
+}
+
+// Only valid on the thread that calls Profiler_EndFrame.
+const ProfileSnapshot *Profiler_GetSnapshot(void) {
+    return &snapshot;
+}
+
+#endif
@@ -0,0 +1,264 @@
+#include "../include/protocol.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const int payloadSize[MSG_COUNT] = {
+    [MSG_READY] = sizeof(ReadyPayload),
+    [MSG_READY_ACK] = sizeof(ReadyPayload),
+    [MSG_MOVE] = sizeof(MovePayload),
+    [MSG_PAUSE_ON] = 0,
+    [MSG_PAUSE_OFF] = 0,
+    [MSG_GIVE_UP] = sizeof(GiveUpPayload),
+    [MSG_ASSIGN] = sizeof(AssignPayload),
+    [MSG_STATE] = sizeof(StatePayload),
+    [MSG_SNAPSHOT] = offsetof(SnapshotPayload, grid), // the grid follows in packed form
+    [MSG_RESUME] = sizeof(ResumePayload),
+    [MSG_RESYNC] = sizeof(ResyncPayload),
+    [MSG_PING] = sizeof(PingPayload),
+    [MSG_PONG] = sizeof(PongPayload),
+};
+
+#define GRID_CELLS (GRID_COLS * GRID_ROWS)
+#define GRID_BITMAP_BYTES ((GRID_CELLS + 7) / 8)
+
+static int Protocol_PackGrid(const char grid[GRID_COLS][GRID_ROWS], uint8_t *out) {
+    const char *cells = &grid[0][0];
+    uint8_t *letters = out + GRID_BITMAP_BYTES;
+    int count = 0;
+    memset(out, 0, GRID_BITMAP_BYTES);
+    for (int i = 0; i < GRID_CELLS; i++) {
+        if (!cells[i]) continue;
+        out[i >> 3] |= (uint8_t)(1 << (i & 7));
+        letters[count++] = (uint8_t)cells[i];
+    }
+    return GRID_BITMAP_BYTES + count;
+}
+
+// Returns the number of bytes consumed, or -1 if the packed grid is truncated or bad.
+static int Protocol_UnpackGrid(const uint8_t *in, int length, char grid[GRID_COLS][GRID_ROWS]) {
+    char *cells = &grid[0][0];
+    int used = GRID_BITMAP_BYTES;
+    if (length < used) return -1;
+    for (int i = 0; i < GRID_CELLS; i++) {
+        cells[i] = '\0';
+        if (!(in[i >> 3] & (1 << (i & 7)))) continue;
+        if (used == length || in[used] < 'A' || in[used] > 'Z') return -1;
+        cells[i] = (char)in[used++];
+    }
+    return used;
+}
+
+static bool Protocol_IsValid(const GameMessage *message) {
+    switch (message->type) {
+        case MSG_READY:
+        case MSG_READY_ACK: return message->ready.playerId < 2;
+        case MSG_MOVE:
+            return message->move.x < GRID_COLS && message->move.y < GRID_ROWS &&
+                   message->move.letter >= 'A' && message->move.letter <= 'Z';
+        case MSG_GIVE_UP: return message->giveUp.playerId < 2;
+        case MSG_ASSIGN: return message->assign.seat < 2;
+        case MSG_STATE:
+            return message->state.x < GRID_COLS && message->state.y < GRID_ROWS &&
+                   message->state.letter >= 'A' && message->state.letter <= 'Z' && message->state.nextPlayer < 2;
+        case MSG_SNAPSHOT: return message->snapshot.currentPlayer < 2;
+        default: return true;
+    }
+}
+
+int Protocol_EncodeBinary(const GameMessage *message, uint8_t *out) {
+    int bodyLen = 1 + payloadSize[message->type];
+    out[2] = (uint8_t)message->type;
+    memcpy(out + 3, &message->ready, payloadSize[message->type]);
+    if (message->type == MSG_SNAPSHOT) bodyLen += Protocol_PackGrid(message->snapshot.grid, out + 2 + bodyLen);
+    out[0] = (uint8_t)(bodyLen >> 8);
+    out[1] = (uint8_t)(bodyLen & 0xFF);
+    return 2 + bodyLen;
+}
+
+int Protocol_BinarySize(const GameMessage *message) {
+    uint8_t frame[PROTOCOL_MAX_FRAME];
+    return Protocol_EncodeBinary(message, frame);
+}
+
+bool Protocol_DecodeBinary(const uint8_t *body, int length, GameMessage *message) {
+    if (length < 1 || body[0] >= MSG_COUNT) return false;
+    message->type = (GameMessageType)body[0];
+    int fixedLen = 1 + payloadSize[message->type];
+    if (message->type == MSG_SNAPSHOT ? length < fixedLen : length != fixedLen) return false;
+    memcpy(&message->ready, body + 1, payloadSize[message->type]);
+    if (message->type == MSG_READY || message->type == MSG_READY_ACK)
+        message->ready.name[MAX_NAME_LENGTH - 1] = '\0';
+    if (message->type == MSG_SNAPSHOT) {
+        message->snapshot.names[0][MAX_NAME_LENGTH - 1] = message->snapshot.names[1][MAX_NAME_LENGTH - 1] = '\0';
+        if (Protocol_UnpackGrid(body + fixedLen, length - fixedLen, message->snapshot.grid) != length - fixedLen) return false;
+    }
+    return Protocol_IsValid(message);
+}
+
+int Protocol_EncodeText(const GameMessage *message, char *out, int maxLen) {
+    switch (message->type) {
+        case MSG_READY: return snprintf(out, maxLen, "READY,%d,%s\n", message->ready.playerId, message->ready.name);
+        case MSG_READY_ACK: return snprintf(out, maxLen, "READY_ACK,%d,%s\n", message->ready.playerId, message->ready.name);
+        case MSG_MOVE:
+            if (Protocol_GetU32(message->move.turnStartMs) == 0)
+                return snprintf(out, maxLen, "MOVE,%d,%d,%c\n", message->move.x, message->move.y, message->move.letter);
+            return snprintf(out, maxLen, "MOVE,%d,%d,%c,%u\n", message->move.x, message->move.y, message->move.letter,
+                            (unsigned)Protocol_GetU32(message->move.turnStartMs));
+        case MSG_PAUSE_ON: return snprintf(out, maxLen, "PAUSE_ON\n");
+        case MSG_PAUSE_OFF: return snprintf(out, maxLen, "PAUSE_OFF\n");
+        case MSG_GIVE_UP: return snprintf(out, maxLen, "GIVE_UP,%d\n", message->giveUp.playerId);
+        case MSG_ASSIGN: return snprintf(out, maxLen, "ASSIGN,%d\n", message->assign.seat);
+        case MSG_RESUME: return snprintf(out, maxLen, "RESUME,%u\n", (unsigned)Protocol_GetU32(message->resume.lastSeq));
+        case MSG_RESYNC:
+            return snprintf(out, maxLen, "RESYNC,%u,%d\n", (unsigned)Protocol_GetU32(message->resync.baseSeq),
+                            (message->resync.count[0] << 8) | message->resync.count[1]);
+        case MSG_STATE:
+            if (Protocol_GetU32(message->state.turnStartMs) == 0)
+                return snprintf(out, maxLen, "STATE,%d,%d,%c,%d,%d,%d\n", message->state.x, message->state.y, message->state.letter,
+                                message->state.nextPlayer, Protocol_StateScore(&message->state, 0), Protocol_StateScore(&message->state, 1));
+            return snprintf(out, maxLen, "STATE,%d,%d,%c,%d,%d,%d,%u\n", message->state.x, message->state.y, message->state.letter,
+                            message->state.nextPlayer, Protocol_StateScore(&message->state, 0), Protocol_StateScore(&message->state, 1),
+                            (unsigned)Protocol_GetU32(message->state.turnStartMs));
+        default: return 0;
+    }
+}
+
+// Widths keep every %[ conversion inside ReadyPayload.name (MAX_NAME_LENGTH - 1).
+bool Protocol_DecodeText(const char *line, GameMessage *message) {
+    int a = -1, b = -1;
+    char letter = 0;
+    memset(message, 0, sizeof(*message));
+    if (strncmp(line, "READY_ACK,", 10) == 0 || strncmp(line, "READY,", 6) == 0) {
+        message->type = (line[5] == '_') ? MSG_READY_ACK : MSG_READY;
+        if (sscanf(strchr(line, ',') + 1, "%d,%15[^\n]", &a, message->ready.name) != 2) return false;
+        if (a < 0 || a > 1) return false;
+        message->ready.playerId = (uint8_t)a;
+    } else if (strncmp(line, "MOVE,", 5) == 0) {
+        message->type = MSG_MOVE;
+        unsigned turnStart = 0;
+        if (sscanf(line + 5, "%d,%d,%c,%u", &a, &b, &letter, &turnStart) < 3) return false;
+        if (a < 0 || a >= GRID_COLS || b < 0 || b >= GRID_ROWS) return false;
+        message->move = (MovePayload){.x = (uint8_t)a, .y = (uint8_t)b, .letter = letter};
+        Protocol_PutU32(message->move.turnStartMs, turnStart);
+    } else if (strncmp(line, "PAUSE_ON", 8) == 0) {
+        message->type = MSG_PAUSE_ON;
+    } else if (strncmp(line, "PAUSE_OFF", 9) == 0) {
+        message->type = MSG_PAUSE_OFF;
+    } else if (strncmp(line, "GIVE_UP,", 8) == 0) {
+        message->type = MSG_GIVE_UP;
+        if (sscanf(line + 8, "%d", &a) != 1 || a < 0 || a > 1) return false;
+        message->giveUp.playerId = (uint8_t)a;
+    } else if (strncmp(line, "ASSIGN,", 7) == 0) {
+        message->type = MSG_ASSIGN;
+        if (sscanf(line + 7, "%d", &a) != 1 || a < 0 || a > 1) return false;
+        message->assign.seat = (uint8_t)a;
+    } else if (strncmp(line, "RESUME,", 7) == 0) {
+        unsigned seq;
+        message->type = MSG_RESUME;
+        if (sscanf(line + 7, "%u", &seq) != 1) return false;
+        Protocol_PutU32(message->resume.lastSeq, seq);
+    } else if (strncmp(line, "RESYNC,", 7) == 0) {
+        unsigned seq;
+        message->type = MSG_RESYNC;
+        if (sscanf(line + 7, "%u,%d", &seq, &a) != 2 || a < 0 || a > 0xFFFF) return false;
+        Protocol_PutU32(message->resync.baseSeq, seq);
+        message->resync.count[0] = (uint8_t)(a >> 8);
+        message->resync.count[1] = (uint8_t)a;
+    } else if (strncmp(line, "STATE,", 6) == 0) {
+        int next = -1, scores[2];
+        unsigned turnStart = 0;
+        message->type = MSG_STATE;
+        if (sscanf(line + 6, "%d,%d,%c,%d,%d,%d,%u", &a, &b, &letter, &next, &scores[0], &scores[1], &turnStart) < 6) return false;
+        if (a < 0 || a >= GRID_COLS || b < 0 || b >= GRID_ROWS || next < 0 || next > 1) return false;
+        if (scores[0] < 0 || scores[0] > 0xFFFF || scores[1] < 0 || scores[1] > 0xFFFF) return false;
+        message->state = Protocol_MakeState(a, b, letter, next, scores, turnStart);
+    } else {
+        return false;
+    }
+    return Protocol_IsValid(message);
+}
+
+StatePayload Protocol_MakeState(int x, int y, char letter, int nextPlayer, const int scores[2], uint32_t turnStartMs) {
+    StatePayload state = {.x = (uint8_t)x, .y = (uint8_t)y, .letter = letter, .nextPlayer = (uint8_t)nextPlayer};
+    Protocol_PutU32(state.turnStartMs, turnStartMs);
+    for (int p = 0; p < 2; p++) {
+        state.scores[p][0] = (uint8_t)((scores[p] >> 8) & 0xFF);
+        state.scores[p][1] = (uint8_t)(scores[p] & 0xFF);
+    }
+    return state;
+}
+
+int Protocol_StateScore(const StatePayload *state, int player) {
+    return (state->scores[player][0] << 8) | state->scores[player][1];
+}
+
+void Protocol_PutU32(uint8_t out[4], uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = (uint8_t)(value >> (24 - 8 * i));
+}
+
+uint32_t Protocol_GetU32(const uint8_t in[4]) {
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+void Protocol_PutU64(uint8_t out[8], uint64_t value) {
+    Protocol_PutU32(out, (uint32_t)(value >> 32));
+    Protocol_PutU32(out + 4, (uint32_t)value);
+}
+
+uint64_t Protocol_GetU64(const uint8_t in[8]) {
+    return ((uint64_t)Protocol_GetU32(in) << 32) | Protocol_GetU32(in + 4);
+}
+
+void Protocol_RunBenchmark(void) {
+    const int count = 1000000, slot = 32; // no benchmark message is longer than slot
+    char *text = malloc((size_t)count * slot);
+    uint8_t *binary = malloc((size_t)count * slot);
+    if (!text || !binary) { free(text); free(binary); return; }
+
+    // Same message mix as a real match: mostly moves, a handshake and the odd pause.
+    int textLen = 0, binaryLen = 0;
+    for (int i = 0; i < count; i++) {
+        GameMessage message = {.type = MSG_MOVE, .move = {.x = i % GRID_COLS, .y = i % GRID_ROWS, .letter = 'A' + i % 26}};
+        if (i % 50 == 0) message = (GameMessage){.type = MSG_READY, .ready = {i & 1, "Benchmark"}};
+        else if (i % 25 == 0) message = (GameMessage){.type = (i & 1) ? MSG_PAUSE_ON : MSG_PAUSE_OFF};
+        int len = Protocol_EncodeText(&message, text + textLen, slot);
+        text[textLen + len - 1] = '\0'; // the receive ring hands lines over NUL-terminated
+        textLen += len;
+        binaryLen += Protocol_EncodeBinary(&message, binary + binaryLen);
+    }
+
+    GameMessage decoded;
+    int ok = 0;
+    clock_t start = clock();
+    for (int pos = 0; pos < textLen; pos += (int)strlen(text + pos) + 1) ok += Protocol_DecodeText(text + pos, &decoded);
+    double textSec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int pos = 0; pos < binaryLen;) {
+        int bodyLen = (binary[pos] << 8) | binary[pos + 1];
+        ok += Protocol_DecodeBinary(binary + pos + 2, bodyLen, &decoded);
+        pos += 2 + bodyLen;
+    }
+    double binarySec = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    // Out-of-range fields must be refused, not wrapped into a byte that passes validation.
+    static const char *malformed[] = {
+        "MOVE,260,3,A", "MOVE,3,266,A", "MOVE,-1,3,A", "READY,256,x", "READY_ACK,2,x", "GIVE_UP,257",
+        "ASSIGN,256", "STATE,259,3,A,0,0,0", "STATE,3,3,A,256,0,0", "STATE,3,3,A,0,65536,0", "STATE,3,3,A,0,0,-1",
+    };
+    int rejected = 0, malformedCount = (int)(sizeof(malformed) / sizeof(malformed[0]));
+    for (int i = 0; i < malformedCount; i++) {
+        if (!Protocol_DecodeText(malformed[i], &decoded)) rejected++;
+        else printf("  accepted malformed line \"%s\"\n", malformed[i]);
+    }
+
+    printf("Protocol benchmark: %d messages, %d decoded\n", count, ok);
+    printf("  malformed: %d of %d lines rejected\n", rejected, malformedCount);
+    printf("  text   v1: %8d bytes, %.0f msgs/s\n", textLen, count / textSec);
+    printf("  binary v2: %8d bytes, %.0f msgs/s\n", binaryLen, count / binarySec);
+    free(text);
+    free(binary);
+}
@@ -0,0 +1,189 @@
+#include "../include/renderbench.h"
+#include "../include/graphics.h"
+#include "../include/logic.h"
+#include "../include/simulation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RENDER_BENCH_MAX_FRAMES 10000
+#define RENDER_BENCH_FRAME_MS 16
+#define RENDER_BENCH_START_TICKS 100000 // pinned clock for the fixtures and the golden frame
+#define RENDER_BENCH_CHANNEL_TOLERANCE 8
+#define RENDER_BENCH_MAX_DIFF_PERMILLE 5
+
+static const struct { GameStateEnum state; const char *name; } benchScreens[] = {
+    {STATE_SPLASH, "splash"}, {STATE_MODE_MENU, "mode_menu"}, {STATE_OPPONENT_MENU, "opponent_menu"},
+    {STATE_BOT_MENU, "bot_menu"}, {STATE_MULTIPLAYER_MENU, "multiplayer_menu"}, {STATE_ENTER_IP, "enter_ip"},
+    {STATE_GET_NAMES, "names"}, {STATE_TUTORIAL, "tutorial"}, {STATE_WAITING_FOR_OPPONENT, "waiting"},
+    {STATE_PLAYING, "playing"}, {STATE_GAME_OVER, "game_over"}, {STATE_MYSTERY_TUTORIAL, "mystery_tutorial"},
+    {STATE_MYSTERY_PLAYING, "mystery"}, {STATE_MYSTERY_GAMEOVER, "mystery_over"},
+};
+
+// A mid-match board: about half full, one scored word still highlighted, a tile being typed.
+static void RenderBench_FillBoard(GameState *game, Uint32 now) {
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            if ((x * 7 + y * 3) % 5 < 2) game->grid[x][y] = (char)('A' + (x * 5 + y * 3) % 26);
+    for (int x = 4; x < 9; x++) {
+        game->grid[x][5] = "WORDS"[x - 4];
+        game->highlightEndTime[x][5] = now + 3600000;
+    }
+    game->isTileSelected = true;
+    game->selectedX = 1;
+    game->selectedY = 1;
+    game->grid[1][1] = '\0';
+    game->currentLetter = 'Q';
+}
+
+static void RenderBench_MakeFixture(GameState *game, GameStateEnum state, Uint32 now) {
+    Logic_InitGameState(game);
+    game->currentState = state;
+    strcpy(game->playerNames[0], "Alice");
+    strcpy(game->playerNames[1], "Bob");
+    game->isSinglePlayer = true;
+    game->tutorialStartTime = now;
+    game->gameStartTime = now - 95000;
+    game->turnStartTime = now - 4000;
+    game->simTime = now;
+    game->scores[0] = 42;
+    game->scores[1] = 37;
+    switch (state) {
+        case STATE_ENTER_IP: strcpy(game->targetIP, "192.168.1.20"); break;
+        case STATE_GET_NAMES: game->currentNameInput = 1; break;
+        case STATE_PLAYING: RenderBench_FillBoard(game, now); break;
+        case STATE_GAME_OVER:
+            strcpy(game->endReason, "Time is up!");
+            strcpy(game->longestWord, "COLLIDE");
+            game->longestWordLen = 7;
+            strcpy(game->bestWord, "QUARTZ");
+            game->bestWordScore = 24;
+            game->forfeitedPlayer = -1;
+            game->turnsPlayed[0] = game->turnsPlayed[1] = 12;
+            game->totalTurnTime[0] = 61000;
+            game->totalTurnTime[1] = 83000;
+            game->bonusWordsCount[0] = 2;
+            break;
+        case STATE_MYSTERY_PLAYING: case STATE_MYSTERY_GAMEOVER: {
+            static const char *guesses[] = {"CRANE", "SLOTH", "WO"};
+            static const int colors[2][MYSTERY_COLS] = {{1, 2, 1, 1, 3}, {1, 1, 3, 2, 1}};
+            strcpy(game->mysteryTarget, "WORLD");
+            for (int r = 0; r < 3; r++)
+                for (int c = 0; guesses[r][c]; c++) game->mysteryGrid[r][c] = guesses[r][c];
+            memcpy(game->mysteryColors, colors, sizeof(colors));
+            game->mysteryRow = 2;
+            game->mysteryCol = 2;
+            game->mysteryState = state == STATE_MYSTERY_GAMEOVER ? 2 : 0;
+            break;
+        }
+        default: break;
+    }
+    Simulation_SyncClocks(game);
+    game->simTickAt = 0; // no interpolation: frames show the fixture's own instant
+    Logic_LayoutScreen(game);
+}
+
+static int RenderBench_CompareMs(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Counts pixels where any channel is off by more than the tolerance; -1 if the golden is unusable.
+static long RenderBench_DiffPixels(SDL_Surface *frame, const char *path) {
+    SDL_Surface *loaded = SDL_LoadBMP(path);
+    SDL_Surface *golden = loaded ? SDL_ConvertSurfaceFormat(loaded, frame->format->format, 0) : NULL;
+    SDL_FreeSurface(loaded);
+    if (!golden || golden->w != frame->w || golden->h != frame->h) { SDL_FreeSurface(golden); return -1; }
+    long differing = 0;
+    for (int y = 0; y < frame->h; y++) {
+        const Uint8 *a = (const Uint8 *)frame->pixels + y * frame->pitch;
+        const Uint8 *b = (const Uint8 *)golden->pixels + y * golden->pitch;
+        for (int x = 0; x < frame->w * 4; x += 4) {
+            bool isDifferent = false;
+            for (int channel = 0; channel < 3; channel++)
+                isDifferent |= abs(a[x + channel] - b[x + channel]) > RENDER_BENCH_CHANNEL_TOLERANCE;
+            differing += isDifferent;
+        }
+    }
+    SDL_FreeSurface(golden);
+    return differing;
+}
+
+int RenderBench_Run(int frames, const char *dumpDir, const char *compareDir) {
+    if (frames < 1) frames = 1;
+    if (frames > RENDER_BENCH_MAX_FRAMES) frames = RENDER_BENCH_MAX_FRAMES;
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    if (SDL_Init(SDL_INIT_VIDEO) < 0 || TTF_Init() < 0) {
+        printf("Render benchmark: SDL init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    AppContext app = {0};
+    SDL_Surface *frame = SDL_CreateRGBSurfaceWithFormat(0, WINDOW_WIDTH, WINDOW_HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    app.renderer = frame ? SDL_CreateSoftwareRenderer(frame) : NULL;
+    app.fontLarge = TTF_OpenFont("assets/arial.ttf", 52);
+    app.fontRegular = TTF_OpenFont("assets/arial.ttf", 24);
+    if (!app.renderer || !app.fontLarge || !app.fontRegular) {
+        printf("Render benchmark: setup failed (run from WORDS_COLLIDE so assets/ is found): %s\n", SDL_GetError());
+        return 1;
+    }
+
+    static GameState game;
+    double *frameMs = malloc(sizeof(double) * frames);
+    int failures = 0;
+    printf("Render benchmark: software renderer, %dx%d, %d frames per screen\n", WINDOW_WIDTH, WINDOW_HEIGHT, frames);
+    printf("screen              p50 ms   p99 ms   max ms  draws/frame  uploads  golden\n");
+    for (size_t s = 0; s < sizeof(benchScreens) / sizeof(benchScreens[0]); s++) {
+        Uint32 ticks = RENDER_BENCH_START_TICKS;
+        RenderBench_MakeFixture(&game, benchScreens[s].state, ticks);
+        long drawCalls = 0, uploads = 0;
+        for (int f = 0; f < frames; f++) {
+            Graphics_PinClock(true, ticks + f * RENDER_BENCH_FRAME_MS);
+            Uint64 start = SDL_GetPerformanceCounter();
+            SDL_RenderClear(app.renderer);
+            Graphics_RenderScreen(&app, &game);
+            SDL_RenderFlush(app.renderer);
+            frameMs[f] = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+            Graphics_EndFrame();
+            GraphicsFrameStats stats;
+            Graphics_GetFrameStats(&stats);
+            drawCalls += stats.drawCalls;
+            uploads += stats.textureUploads;
+        }
+        qsort(frameMs, frames, sizeof(double), RenderBench_CompareMs);
+
+        // The image check always uses the same instant, whatever the frame count.
+        RenderBench_MakeFixture(&game, benchScreens[s].state, ticks);
+        Graphics_PinClock(true, ticks);
+        SDL_RenderClear(app.renderer);
+        Graphics_RenderScreen(&app, &game);
+        SDL_RenderFlush(app.renderer);
+        Graphics_EndFrame();
+        char path[512], golden[48] = "-";
+        if (dumpDir) {
+            snprintf(path, sizeof(path), "%s/%s.bmp", dumpDir, benchScreens[s].name);
+            if (SDL_SaveBMP(frame, path) != 0) printf("Render benchmark: could not write %s\n", path);
+        }
+        if (compareDir) {
+            snprintf(path, sizeof(path), "%s/%s.bmp", compareDir, benchScreens[s].name);
+            long differing = RenderBench_DiffPixels(frame, path);
+            bool isMatch = differing >= 0 && differing * 1000 <= (long)frame->w * frame->h * RENDER_BENCH_MAX_DIFF_PERMILLE;
+            if (differing < 0) snprintf(golden, sizeof(golden), "missing");
+            else snprintf(golden, sizeof(golden), "%s (%ld px)", isMatch ? "ok" : "DIFF", differing);
+            failures += !isMatch;
+        }
+        printf("%-18s %7.3f  %7.3f  %7.3f  %11.1f  %7ld  %s\n", benchScreens[s].name, frameMs[frames / 2],
+               frameMs[(frames * 99) / 100 < frames ? (frames * 99) / 100 : frames - 1], frameMs[frames - 1],
+               (double)drawCalls / frames, uploads, golden);
+    }
+
+    free(frameMs);
+    Graphics_PinClock(false, 0);
+    Graphics_Cleanup();
+    TTF_CloseFont(app.fontLarge);
+    TTF_CloseFont(app.fontRegular);
+    SDL_DestroyRenderer(app.renderer);
+    SDL_FreeSurface(frame);
+    TTF_Quit();
+    SDL_Quit();
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+#include "../include/renderthread.h"
+#include "../include/assets.h"
+#include "../include/frame.h"
+#include "../include/graphics.h"
+#include "../include/input.h"
+#include "../include/profiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RENDER_IDLE_WAIT_MS 250
+#define RENDER_LATENCY_SAMPLES 4096
+#define RENDER_EVENT_QUEUE_SIZE 256
+
+// Triple buffer. The game thread fills slots[back] and swaps it with `ready`; the render thread
+// swaps `ready` into `front` when a newer one is waiting. Only the index swaps are locked, so
+// neither thread ever waits on the other's copy or frame.
+static GameState slots[3];
+static Uint64 publishedAt[3];
+static int front = 0, ready = 1, back = 2;
+static bool hasNewSnapshot = false;
+static bool isRenderWaiting = false; // idle in SDL_WaitEventTimeout; a publish has to wake it
+static SDL_mutex *lock;
+
+// Events pumped on the render thread, in order, for the game thread.
+static SDL_Event events[RENDER_EVENT_QUEUE_SIZE];
+static int eventHead = 0, eventCount = 0;
+static long droppedEventCount = 0;
+static SDL_mutex *eventLock;
+static SDL_cond *eventPushed;
+
+static AppContext *renderApp;
+static Uint32 wakeEventType = (Uint32)-1;
+static SDL_atomic_t isRunning;
+
+typedef struct {
+    SDL_ThreadFunction main;
+    void *data;
+} GameThreadStart;
+
+// Handoff latency, from publish to the render thread picking the snapshot up.
+static Uint32 latencyUs[RENDER_LATENCY_SAMPLES];
+static long latencyCount = 0;
+static Uint32 maxLatencyUs = 0;
+static long publishedCount = 0, supersededCount = 0;
+
+static const GameState *RenderThread_Acquire(void) {
+    SDL_LockMutex(lock);
+    bool isNew = hasNewSnapshot;
+    if (isNew) {
+        int swap = front;
+        front = ready;
+        ready = swap;
+        hasNewSnapshot = false;
+    }
+    SDL_UnlockMutex(lock);
+    if (isNew) {
+        Uint32 us = (Uint32)((SDL_GetPerformanceCounter() - publishedAt[front]) * 1000000 / SDL_GetPerformanceFrequency());
+        latencyUs[latencyCount++ % RENDER_LATENCY_SAMPLES] = us;
+        if (us > maxLatencyUs) maxLatencyUs = us;
+    }
+    return &slots[front];
+}
+
+static void RenderThread_Wake(void) {
+    if (wakeEventType == (Uint32)-1) return; // no event type left; the idle wait just runs out
+    SDL_Event wake = {.type = wakeEventType};
+    SDL_PushEvent(&wake);
+}
+
+static void RenderThread_HandleEvent(const SDL_Event *event) {
+    if (event->type == wakeEventType) return;
+    if (event->type == SDL_RENDER_TARGETS_RESET) {
+        Graphics_ResetRenderTargets();
+        return;
+    }
+    SDL_LockMutex(eventLock);
+    if (eventCount < RENDER_EVENT_QUEUE_SIZE) {
+        events[(eventHead + eventCount++) % RENDER_EVENT_QUEUE_SIZE] = *event;
+        SDL_CondSignal(eventPushed);
+    } else {
+        droppedEventCount++;
+    }
+    SDL_UnlockMutex(eventLock);
+}
+
+// Idle: blocks in the event pump until there is input, a new snapshot or the timeout.
+static void RenderThread_WaitForWork(Uint32 timeoutMs) {
+    SDL_LockMutex(lock);
+    bool isWaiting = !hasNewSnapshot && SDL_AtomicGet(&isRunning);
+    isRenderWaiting = isWaiting;
+    SDL_UnlockMutex(lock);
+    if (!isWaiting) return;
+    SDL_Event event;
+    if (SDL_WaitEventTimeout(&event, timeoutMs)) RenderThread_HandleEvent(&event);
+    SDL_LockMutex(lock);
+    isRenderWaiting = false;
+    SDL_UnlockMutex(lock);
+}
+
+static int RenderThread_GameMain(void *data) {
+    const GameThreadStart *start = data;
+    int result = start->main(start->data);
+    SDL_AtomicSet(&isRunning, 0);
+    RenderThread_Wake();
+    return result;
+}
+
+bool RenderThread_Start(AppContext *app, const GameState *game) {
+    app->renderer = SDL_CreateRenderer(app->window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if (!app->renderer) {
+        printf("Render: could not create a renderer: %s\n", SDL_GetError());
+        return false;
+    }
+    Frame_Init(app);
+    lock = SDL_CreateMutex();
+    eventLock = SDL_CreateMutex();
+    eventPushed = SDL_CreateCond();
+    wakeEventType = SDL_RegisterEvents(1);
+    memcpy(&slots[front], game, sizeof(GameState));
+    renderApp = app;
+    return true;
+}
+
+int RenderThread_Run(SDL_ThreadFunction gameMain, void *data) {
+    AppContext *app = renderApp;
+    GameThreadStart start = {gameMain, data};
+    SDL_AtomicSet(&isRunning, 1);
+    SDL_Thread *gameThread = SDL_CreateThread(RenderThread_GameMain, "game", &start);
+    if (!gameThread) {
+        printf("Render: could not start the game thread: %s\n", SDL_GetError());
+        return -1;
+    }
+
+    bool hasPresented = false;
+    while (SDL_AtomicGet(&isRunning)) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) RenderThread_HandleEvent(&event);
+        Input_ApplyTextInput();
+
+        const GameState *game = RenderThread_Acquire();
+        Assets_ResolveFonts(app);
+        Frame_Begin();
+        GameStateEnum screen = game->currentState;
+        bool isVisible = Frame_IsWindowVisible();
+        if (isVisible) {
+            PROFILE_BEGIN(PROFILE_RENDER);
+            SDL_RenderClear(app->renderer);
+            Graphics_RenderScreen(app, game);
+            PROFILE_END(PROFILE_RENDER);
+            PROFILE_DRAW_OVERLAY(app);
+        }
+        Frame_Finish(app, screen, isVisible);
+        if (isVisible && !hasPresented) {
+            hasPresented = true;
+            printf("Render: first frame %.1f ms after launch%s\n", (SDL_GetPerformanceCounter() - app->launchedAt) * 1000.0 / SDL_GetPerformanceFrequency(),
+                   app->fontRegular ? "" : " (fonts still loading)");
+        }
+        if (isVisible) Graphics_EndFrame();
+        PROFILE_END_FRAME();
+        if (Frame_IsIdle(game)) RenderThread_WaitForWork(RENDER_IDLE_WAIT_MS);
+    }
+
+    int result = 0;
+    SDL_WaitThread(gameThread, &result);
+    return result;
+}
+
+bool RenderThread_NextEvent(SDL_Event *event, Uint32 timeoutMs) {
+    SDL_LockMutex(eventLock);
+    if (eventCount == 0 && timeoutMs > 0) SDL_CondWaitTimeout(eventPushed, eventLock, timeoutMs);
+    bool hasEvent = eventCount > 0;
+    if (hasEvent) {
+        *event = events[eventHead];
+        eventHead = (eventHead + 1) % RENDER_EVENT_QUEUE_SIZE;
+        eventCount--;
+    }
+    SDL_UnlockMutex(eventLock);
+    return hasEvent;
+}
+
+void RenderThread_Publish(const GameState *game) {
+    memcpy(&slots[back], game, sizeof(GameState));
+    publishedAt[back] = SDL_GetPerformanceCounter();
+    SDL_LockMutex(lock);
+    int swap = back;
+    back = ready;
+    ready = swap;
+    if (hasNewSnapshot) supersededCount++;
+    hasNewSnapshot = true;
+    bool isWaiting = isRenderWaiting;
+    isRenderWaiting = false;
+    SDL_UnlockMutex(lock);
+    if (isWaiting) RenderThread_Wake();
+    publishedCount++;
+}
+
+static int RenderThread_CompareUs(const void *a, const void *b) {
+    Uint32 x = *(const Uint32 *)a, y = *(const Uint32 *)b;
+    return (x > y) - (x < y);
+}
+
+void RenderThread_Stop(void) {
+    if (renderApp && renderApp->renderer) {
+        Graphics_Cleanup();
+        SDL_DestroyRenderer(renderApp->renderer);
+        renderApp->renderer = NULL;
+    }
+    int samples = latencyCount < RENDER_LATENCY_SAMPLES ? (int)latencyCount : RENDER_LATENCY_SAMPLES;
+    if (samples > 0) {
+        qsort(latencyUs, samples, sizeof(latencyUs[0]), RenderThread_CompareUs);
+        printf("Render: %ld snapshots published, %ld picked up, %ld replaced before the render thread got to them\n",
+               publishedCount, latencyCount, supersededCount);
+        printf("Render: handoff latency p50 %.2f ms  p99 %.2f ms  max %.2f ms (last %d)\n",
+               latencyUs[samples / 2] / 1000.0, latencyUs[samples * 99 / 100] / 1000.0, maxLatencyUs / 1000.0, samples);
+    }
+    if (droppedEventCount > 0) printf("Render: %ld events dropped with the game thread's queue full\n", droppedEventCount);
+    if (eventPushed) SDL_DestroyCond(eventPushed);
+    if (eventLock) SDL_DestroyMutex(eventLock);
+    if (lock) SDL_DestroyMutex(lock);
+    eventPushed = NULL;
+    eventLock = NULL;
+    lock = NULL;
+}
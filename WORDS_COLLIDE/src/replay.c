@@ -0,0 +1,310 @@
+#include "../include/replay.h"
+#include <stdio.h>
+#include <string.h>
+
+#define REPLAY_MAGIC "WCR"
+#define REPLAY_VERSION 1
+#define REPLAY_X_BITS 5
+#define REPLAY_Y_BITS 4
+#define REPLAY_LETTER_BITS 5
+
+// The recording in progress (game thread only).
+static Replay recording;
+static bool isRecording = false;
+static Uint32 startedAt = 0, recordedUnits = 0; // match time so far, in REPLAY_TIME_UNIT_MS
+
+typedef struct {
+    const Uint8 *bytes;
+    Uint32 position, end;
+    bool isOverrun;
+} ReplayReader;
+
+// Bits are written most significant first into a zeroed stream. Returns false (and writes
+// nothing) if the stream is full.
+static bool Replay_PutBits(Uint32 value, int width) {
+    if (recording.streamBits + width > REPLAY_MAX_BYTES * 8) return false;
+    for (int i = width - 1; i >= 0; i--) {
+        if ((value >> i) & 1) recording.stream[recording.streamBits >> 3] |= (Uint8)(0x80 >> (recording.streamBits & 7));
+        recording.streamBits++;
+    }
+    return true;
+}
+
+// Elias gamma code for value >= 1: small numbers (most scores and gaps) take a few bits.
+static bool Replay_PutGamma(Uint32 value) {
+    int width = 0;
+    while ((value >> width) > 1) width++;
+    return Replay_PutBits(0, width) && Replay_PutBits(value, width + 1);
+}
+
+static Uint32 Replay_GetBits(ReplayReader *reader, int width) {
+    if (reader->position + width > reader->end) {
+        reader->isOverrun = true;
+        return 0;
+    }
+    Uint32 value = 0;
+    for (int i = 0; i < width; i++, reader->position++)
+        value = (value << 1) | ((reader->bytes[reader->position >> 3] >> (7 - (reader->position & 7))) & 1);
+    return value;
+}
+
+static Uint32 Replay_GetGamma(ReplayReader *reader) {
+    int width = 0;
+    while (!reader->isOverrun && Replay_GetBits(reader, 1) == 0) width++;
+    if (width > 31) {
+        reader->isOverrun = true;
+        return 0;
+    }
+    return (1u << width) | Replay_GetBits(reader, width);
+}
+
+// Match time, occupied cell count, then (if any) an occupancy bitmap and one letter per
+// occupied cell, then scores and side to move.
+static bool Replay_PutKeyframe(const GameState *game) {
+    if (recording.keyframeCount == REPLAY_MAX_KEYFRAMES) return false;
+    recording.keyframeAt[recording.keyframeCount] = (Uint16)recording.streamBits;
+    int occupied = 0;
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            occupied += game->grid[x][y] != '\0';
+    bool isWritten = Replay_PutGamma(recordedUnits + 1) && Replay_PutGamma(occupied + 1);
+    for (int x = 0; x < GRID_COLS && occupied > 0; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            isWritten = isWritten && Replay_PutBits(game->grid[x][y] != '\0', 1);
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            if (game->grid[x][y]) isWritten = isWritten && Replay_PutBits((Uint32)(game->grid[x][y] - 'A'), REPLAY_LETTER_BITS);
+    isWritten = isWritten && Replay_PutGamma((Uint32)game->scores[0] + 1) && Replay_PutGamma((Uint32)game->scores[1] + 1) &&
+                Replay_PutBits((Uint32)game->currentPlayer, 1);
+    if (isWritten) recording.keyframeCount++;
+    return isWritten;
+}
+
+static bool Replay_IsRecordable(const GameState *game) {
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            if (game->grid[x][y] && (game->grid[x][y] < 'A' || game->grid[x][y] > 'Z')) return false;
+    return game->scores[0] >= 0 && game->scores[1] >= 0;
+}
+
+void Replay_Begin(const GameState *game) {
+    memset(&recording, 0, sizeof(recording));
+    recording.gameMode = (Uint8)game->gameMode;
+    recording.flags = (game->isMultiplayer ? REPLAY_FLAG_MULTIPLAYER : 0) | (game->isSinglePlayer ? REPLAY_FLAG_BOT : 0) |
+                      (game->isServerMatch ? REPLAY_FLAG_SERVER : 0) | (game->isSpectator ? REPLAY_FLAG_SPECTATOR : 0);
+    memcpy(recording.playerNames, game->playerNames, sizeof(recording.playerNames));
+    startedAt = game->simTime;
+    recordedUnits = 0;
+    isRecording = Replay_IsRecordable(game) && Replay_PutKeyframe(game);
+}
+
+void Replay_RecordMove(const GameState *game, int x, int y, char letter, int player, int scoreDelta, int rulesScore) {
+    if (!isRecording) return;
+    Uint32 startBits = recording.streamBits;
+    Uint32 units = (game->simTime - startedAt) / REPLAY_TIME_UNIT_MS; // gaps add up to this exactly
+    bool isRulesScore = scoreDelta == (rulesScore > 0 ? rulesScore : 0);
+    bool isWritten = letter >= 'A' && letter <= 'Z' && scoreDelta >= 0 &&
+                     Replay_PutBits((Uint32)x, REPLAY_X_BITS) && Replay_PutBits((Uint32)y, REPLAY_Y_BITS) &&
+                     Replay_PutBits((Uint32)(letter - 'A'), REPLAY_LETTER_BITS) && Replay_PutBits((Uint32)player, 1) &&
+                     Replay_PutGamma(units - recordedUnits + 1) &&
+                     Replay_PutBits(isRulesScore, 1) && (isRulesScore || Replay_PutGamma((Uint32)scoreDelta + 1));
+    if (isWritten) {
+        recording.moveCount++;
+        Uint32 previousUnits = recordedUnits;
+        recordedUnits = units;
+        if (recording.moveCount % REPLAY_KEYFRAME_INTERVAL != 0 || Replay_PutKeyframe(game)) return;
+        recording.moveCount--; // every multiple of the interval needs its keyframe to be seekable
+        recordedUnits = previousUnits;
+    }
+    // Out of room (or a move the format cannot hold): keep what fits and stop.
+    for (Uint32 bit = startBits; bit < recording.streamBits; bit++)
+        recording.stream[bit >> 3] &= (Uint8)~(0x80 >> (bit & 7));
+    recording.streamBits = startBits;
+    isRecording = false;
+    printf("Replay: recording stopped after %d moves\n", recording.moveCount);
+}
+
+static void Replay_PutU16(Uint8 *out, Uint32 value) {
+    out[0] = (Uint8)(value >> 8);
+    out[1] = (Uint8)value;
+}
+
+static Uint32 Replay_GetU16(const Uint8 *in) {
+    return ((Uint32)in[0] << 8) | in[1];
+}
+
+// Header, names, keyframe offsets, then the bit stream, assembled so the file is one fwrite.
+void Replay_Finish(void) {
+    if (!isRecording) return;
+    isRecording = false;
+    if (recording.moveCount == 0) return;
+    static Uint8 file[32 + 2 * MAX_NAME_LENGTH + 2 * REPLAY_MAX_KEYFRAMES + REPLAY_MAX_BYTES];
+    size_t size = 0;
+    memcpy(file, REPLAY_MAGIC, 3);
+    file[3] = REPLAY_VERSION;
+    file[4] = recording.gameMode;
+    file[5] = recording.flags;
+    file[6] = REPLAY_KEYFRAME_INTERVAL;
+    file[7] = (Uint8)recording.keyframeCount;
+    Replay_PutU16(file + 8, (Uint32)recording.moveCount);
+    Replay_PutU16(file + 10, recording.streamBits);
+    size = 12;
+    for (int p = 0; p < 2; p++) {
+        recording.playerNames[p][MAX_NAME_LENGTH - 1] = '\0';
+        size_t length = strlen(recording.playerNames[p]);
+        file[size++] = (Uint8)length;
+        memcpy(file + size, recording.playerNames[p], length);
+        size += length;
+    }
+    for (int k = 0; k < recording.keyframeCount; k++, size += 2)
+        Replay_PutU16(file + size, recording.keyframeAt[k]);
+    memcpy(file + size, recording.stream, (recording.streamBits + 7) / 8);
+    size += (recording.streamBits + 7) / 8;
+
+    FILE *out = fopen(REPLAY_PATH, "wb");
+    if (!out || fwrite(file, 1, size, out) != size) printf("Replay: could not write %s\n", REPLAY_PATH);
+    else printf("Replay: %d moves in %zu bytes written to %s\n", recording.moveCount, size, REPLAY_PATH);
+    if (out) fclose(out);
+}
+
+bool Replay_Load(const char *path, Replay *replay) {
+    static Uint8 file[32 + 2 * MAX_NAME_LENGTH + 2 * REPLAY_MAX_KEYFRAMES + REPLAY_MAX_BYTES + 1];
+    FILE *in = fopen(path, "rb");
+    if (!in) return false;
+    size_t size = fread(file, 1, sizeof(file), in);
+    fclose(in);
+    memset(replay, 0, sizeof(*replay));
+    if (size < 12 || memcmp(file, REPLAY_MAGIC, 3) != 0 || file[3] != REPLAY_VERSION || file[6] != REPLAY_KEYFRAME_INTERVAL)
+        return false;
+    replay->gameMode = file[4];
+    replay->flags = file[5];
+    replay->keyframeCount = file[7];
+    replay->moveCount = (int)Replay_GetU16(file + 8);
+    replay->streamBits = Replay_GetU16(file + 10);
+    if (replay->keyframeCount < 1 || replay->keyframeCount > REPLAY_MAX_KEYFRAMES ||
+        replay->keyframeCount != replay->moveCount / REPLAY_KEYFRAME_INTERVAL + 1 || replay->streamBits > REPLAY_MAX_BYTES * 8)
+        return false;
+    size_t offset = 12;
+    for (int p = 0; p < 2; p++) {
+        size_t length = offset < size ? file[offset++] : MAX_NAME_LENGTH;
+        if (length >= MAX_NAME_LENGTH || offset + length > size) return false;
+        memcpy(replay->playerNames[p], file + offset, length);
+        offset += length;
+    }
+    if (offset + 2 * replay->keyframeCount + (replay->streamBits + 7) / 8 != size) return false;
+    for (int k = 0; k < replay->keyframeCount; k++, offset += 2) {
+        replay->keyframeAt[k] = (Uint16)Replay_GetU16(file + offset);
+        if (replay->keyframeAt[k] >= replay->streamBits) return false;
+    }
+    memcpy(replay->stream, file + offset, (replay->streamBits + 7) / 8);
+    return true;
+}
+
+// Returns the match time at the keyframe in milliseconds.
+static Uint32 Replay_GetKeyframe(ReplayReader *reader, BoardState *board) {
+    memset(board, 0, sizeof(*board));
+    Uint32 matchMs = (Replay_GetGamma(reader) - 1) * REPLAY_TIME_UNIT_MS;
+    Uint32 occupied = Replay_GetGamma(reader) - 1;
+    if (occupied > GRID_COLS * GRID_ROWS) reader->isOverrun = true;
+    for (int x = 0; x < GRID_COLS && occupied > 0; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            board->grid[x][y] = Replay_GetBits(reader, 1) ? '?' : '\0';
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            if (board->grid[x][y]) board->grid[x][y] = (char)('A' + Replay_GetBits(reader, REPLAY_LETTER_BITS));
+    board->scores[0] = (int)Replay_GetGamma(reader) - 1;
+    board->scores[1] = (int)Replay_GetGamma(reader) - 1;
+    board->sideToMove = (Uint8)Replay_GetBits(reader, 1);
+    Board_SyncOccupancy(board);
+    return matchMs;
+}
+
+// Applies the next move the way a live game does: the letter goes down, the rules rate it,
+// and the mover gets the rules' score unless the log says otherwise (bots, servers).
+static Uint32 Replay_ApplyMove(ReplayReader *reader, BoardState *board) {
+    int x = (int)Replay_GetBits(reader, REPLAY_X_BITS);
+    int y = (int)Replay_GetBits(reader, REPLAY_Y_BITS);
+    char letter = (char)('A' + Replay_GetBits(reader, REPLAY_LETTER_BITS));
+    int player = (int)Replay_GetBits(reader, 1);
+    Uint32 elapsed = (Replay_GetGamma(reader) - 1) * REPLAY_TIME_UNIT_MS;
+    bool isRulesScore = Replay_GetBits(reader, 1);
+    int scoreDelta = isRulesScore ? 0 : (int)Replay_GetGamma(reader) - 1;
+    if (reader->isOverrun || x >= GRID_COLS || y >= GRID_ROWS || Board_IsOccupied(board, x, y)) {
+        reader->isOverrun = true;
+        return 0;
+    }
+    BoardUndo undo;
+    board->sideToMove = (Uint8)player;
+    if (isRulesScore) Board_MakeMove(board, x, y, letter, &undo);
+    else Board_MakeScoredMove(board, x, y, letter, scoreDelta, &undo);
+    return elapsed;
+}
+
+Uint32 Replay_Seek(const Replay *replay, int turn, BoardState *board) {
+    if (turn < 0) turn = 0;
+    if (turn > replay->moveCount) turn = replay->moveCount;
+    int keyframe = turn / REPLAY_KEYFRAME_INTERVAL;
+    ReplayReader reader = {replay->stream, replay->keyframeAt[keyframe], replay->streamBits, false};
+    Uint32 matchMs = Replay_GetKeyframe(&reader, board);
+    for (int move = keyframe * REPLAY_KEYFRAME_INTERVAL; move < turn && !reader.isOverrun; move++)
+        matchMs += Replay_ApplyMove(&reader, board);
+    return matchMs;
+}
+
+// Plays the whole log from the first keyframe, checking each later keyframe against the board
+// the moves produced. Returns the number of keyframes that disagree, or -1 if the log is cut short.
+static int Replay_Verify(const Replay *replay, BoardState *board) {
+    BoardState keyframe;
+    ReplayReader reader = {replay->stream, replay->keyframeAt[0], replay->streamBits, false};
+    Replay_GetKeyframe(&reader, board);
+    int mismatches = 0;
+    for (int move = 0; move < replay->moveCount && !reader.isOverrun; move++) {
+        Replay_ApplyMove(&reader, board);
+        if ((move + 1) % REPLAY_KEYFRAME_INTERVAL != 0) continue;
+        Replay_GetKeyframe(&reader, &keyframe);
+        mismatches += memcmp(keyframe.grid, board->grid, sizeof(board->grid)) != 0 || keyframe.scores[0] != board->scores[0] ||
+                      keyframe.scores[1] != board->scores[1] || keyframe.sideToMove != board->sideToMove;
+    }
+    return reader.isOverrun ? -1 : mismatches;
+}
+
+int Replay_Run(const char *path, int turn) {
+    static Replay replay;
+    BoardState board;
+    if (!Replay_Load(path, &replay)) {
+        printf("Replay: %s is missing or not a version %d replay\n", path, REPLAY_VERSION);
+        return 1;
+    }
+    printf("Replay: %s vs %s, %d moves, %d keyframes, %u bytes of moves and keyframes\n",
+           replay.playerNames[0][0] ? replay.playerNames[0] : "Player 1", replay.playerNames[1][0] ? replay.playerNames[1] : "Player 2",
+           replay.moveCount, replay.keyframeCount, (replay.streamBits + 7) / 8);
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 start = SDL_GetPerformanceCounter();
+    int mismatches = Replay_Verify(&replay, &board);
+    double verifyUs = (SDL_GetPerformanceCounter() - start) * 1000000.0 / frequency;
+    if (mismatches != 0) {
+        printf("Replay: %s\n", mismatches < 0 ? "the move log is truncated" : "keyframes disagree with the moves before them");
+        return 1;
+    }
+    double maxSeekUs = 0, totalSeekUs = 0;
+    for (int t = 0; t <= replay.moveCount; t++) {
+        start = SDL_GetPerformanceCounter();
+        Replay_Seek(&replay, t, &board);
+        double us = (SDL_GetPerformanceCounter() - start) * 1000000.0 / frequency;
+        totalSeekUs += us;
+        if (us > maxSeekUs) maxSeekUs = us;
+    }
+    printf("Replay: whole game fast-forwarded in %.1f us; seek avg %.2f us, max %.2f us over %d turns\n",
+           verifyUs, totalSeekUs / (replay.moveCount + 1), maxSeekUs, replay.moveCount + 1);
+
+    if (turn < 0 || turn > replay.moveCount) turn = replay.moveCount;
+    Uint32 matchMs = Replay_Seek(&replay, turn, &board);
+    printf("\nTurn %d at %u:%02u, scores %d - %d, %s to move\n", turn, matchMs / 60000, matchMs / 1000 % 60,
+           board.scores[0], board.scores[1], board.sideToMove == 0 ? "player 1" : "player 2");
+    for (int y = 0; y < GRID_ROWS; y++) {
+        for (int x = 0; x < GRID_COLS; x++) printf(" %c", board.grid[x][y] ? board.grid[x][y] : '.');
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include "../include/rules.h"
+#include <stdlib.h>
+
+bool Rules_IsLegalMove(const char grid[GRID_COLS][GRID_ROWS], int x, int y, char letter) {
+    if (x < 0 || x >= GRID_COLS || y < 0 || y >= GRID_ROWS) return false;
+    if (letter < 'A' || letter > 'Z') return false;
+    return grid[x][y] == '\0';
+}
+
+int Rules_ScorePlacement(const char grid[GRID_COLS][GRID_ROWS], int x, int y, char letter) {
+    return PLACEMENT_SCORE; // Base valid placement score
+}
+
+MatchEndReason Rules_CheckEnd(const char grid[GRID_COLS][GRID_ROWS], const int scores[2]) {
+    // RULE 1: 400 Point Limit
+    if (scores[0] >= WIN_SCORE || scores[1] >= WIN_SCORE) return END_SCORE_LIMIT;
+    // RULE 2: 70 Point Mercy Lead
+    if (abs(scores[0] - scores[1]) >= MERCY_LEAD && (scores[0] > 0 || scores[1] > 0)) return END_MERCY_LEAD;
+    // RULE 3: 85% Board Fill
+    int filled = 0;
+    for (int x = 0; x < GRID_COLS; x++) {
+        for (int y = 0; y < GRID_ROWS; y++) {
+            if (grid[x][y] != '\0') filled++;
+        }
+    }
+    if (filled >= (GRID_COLS * GRID_ROWS * MAX_BOARD_FILL)) return END_BOARD_FULL;
+    return END_NONE;
+}
+
+const char *Rules_EndReasonText(MatchEndReason reason) {
+    switch (reason) {
+        case END_SCORE_LIMIT: return "Score Limit Reached (400+)!";
+        case END_MERCY_LEAD: return "Dominance! (70+ Point Lead)";
+        case END_BOARD_FULL: return "Board is 85% Full!";
+        default: return "";
+    }
+}
@@ -0,0 +1,143 @@
+#include "../include/save.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SAVE_MAGIC "WCS"
+#define SAVE_TEMP_PATH SAVE_PATH ".tmp"
+
+static bool hasSave = false;
+static int savedMoves = -1;
+
+static Uint32 Save_Checksum(const SaveGame *save) {
+    SaveGame copy = *save;
+    copy.checksum = 0;
+    const Uint8 *bytes = (const Uint8 *)&copy;
+    Uint32 hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(copy); i++) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+bool Save_IsSaveable(const GameState *game) {
+    return game->currentState == STATE_PLAYING && !game->isMultiplayer && !game->isSpectator;
+}
+
+bool Save_Write(const GameState *game) {
+    if (!Save_IsSaveable(game)) return false;
+    SaveGame save;
+    memset(&save, 0, sizeof(save));
+    memcpy(save.magic, SAVE_MAGIC, 3);
+    save.version = SAVE_VERSION;
+    save.size = sizeof(save);
+    save.isSinglePlayer = game->isSinglePlayer;
+    save.botDifficulty = (Uint8)game->botDifficulty;
+    save.gameMode = (Uint8)game->gameMode;
+    save.currentPlayer = (Uint8)game->currentPlayer;
+    memcpy(save.playerNames, game->playerNames, sizeof(save.playerNames));
+    memcpy(save.grid, game->grid, sizeof(save.grid));
+    for (int p = 0; p < 2; p++) {
+        save.scores[p] = game->scores[p];
+        save.totalTurnTime[p] = game->totalTurnTime[p];
+        save.turnsPlayed[p] = game->turnsPlayed[p];
+        save.bonusWordsCount[p] = game->bonusWordsCount[p];
+    }
+    save.scoredWordCount = game->scoredWordCount;
+    memcpy(save.scoredWords, game->scoredWords, sizeof(save.scoredWords));
+    save.gameElapsedMs = game->simTime - game->gameStartTime;
+    save.turnElapsedMs = game->simTime - game->turnStartTime;
+    memcpy(save.longestWord, game->longestWord, sizeof(save.longestWord));
+    memcpy(save.bestWord, game->bestWord, sizeof(save.bestWord));
+    save.longestWordLen = game->longestWordLen;
+    save.bestWordScore = game->bestWordScore;
+    save.checksum = Save_Checksum(&save);
+
+    // A crash mid-write leaves the previous save in place rather than half of this one.
+    FILE *out = fopen(SAVE_TEMP_PATH, "wb");
+    bool isWritten = out && fwrite(&save, sizeof(save), 1, out) == 1;
+    if (out && fclose(out) != 0) isWritten = false;
+    if (isWritten && rename(SAVE_TEMP_PATH, SAVE_PATH) != 0) {
+        remove(SAVE_PATH); // Windows will not rename over an existing file
+        isWritten = rename(SAVE_TEMP_PATH, SAVE_PATH) == 0;
+    }
+    if (!isWritten) {
+        printf("Save: could not write %s\n", SAVE_PATH);
+        return false;
+    }
+    hasSave = true;
+    savedMoves = game->turnsPlayed[0] + game->turnsPlayed[1];
+    return true;
+}
+
+void Save_Autosave(const GameState *game) {
+    if (Save_IsSaveable(game) && game->turnsPlayed[0] + game->turnsPlayed[1] != savedMoves) Save_Write(game);
+}
+
+static bool Save_IsTerminated(const char *text, size_t size) {
+    return memchr(text, '\0', size) != NULL;
+}
+
+static bool Save_IsValid(const SaveGame *save) {
+    if (memcmp(save->magic, SAVE_MAGIC, 3) != 0 || save->version != SAVE_VERSION || save->size != sizeof(*save) ||
+        save->checksum != Save_Checksum(save))
+        return false;
+    if (save->currentPlayer > 1 || save->gameMode > 1 || save->isSinglePlayer > 1) return false;
+    if (save->scoredWordCount < 0 || save->scoredWordCount > MAX_SCORED_WORDS) return false;
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            if (save->grid[x][y] && (save->grid[x][y] < 'A' || save->grid[x][y] > 'Z')) return false;
+    for (int w = 0; w < save->scoredWordCount; w++)
+        if (!Save_IsTerminated(save->scoredWords[w], MAX_WORD_LENGTH)) return false;
+    return Save_IsTerminated(save->playerNames[0], MAX_NAME_LENGTH) && Save_IsTerminated(save->playerNames[1], MAX_NAME_LENGTH) &&
+           Save_IsTerminated(save->longestWord, MAX_WORD_LENGTH) && Save_IsTerminated(save->bestWord, MAX_WORD_LENGTH);
+}
+
+bool Save_Load(GameState *game) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    SaveGame save;
+    FILE *in = fopen(SAVE_PATH, "rb");
+    if (!in) return false;
+    bool isRead = fread(&save, sizeof(save), 1, in) == 1 && fgetc(in) == EOF;
+    fclose(in);
+    if (!isRead || !Save_IsValid(&save)) {
+        printf("Save: ignoring %s (not a version %d save from this build, or damaged)\n", SAVE_PATH, SAVE_VERSION);
+        return false;
+    }
+
+    game->currentState = STATE_PLAYING;
+    game->isSinglePlayer = save.isSinglePlayer;
+    game->botDifficulty = save.botDifficulty;
+    game->gameMode = save.gameMode;
+    game->currentPlayer = save.currentPlayer;
+    memcpy(game->playerNames, save.playerNames, sizeof(save.playerNames));
+    memcpy(game->grid, save.grid, sizeof(save.grid));
+    for (int p = 0; p < 2; p++) {
+        game->scores[p] = save.scores[p];
+        game->totalTurnTime[p] = save.totalTurnTime[p];
+        game->turnsPlayed[p] = save.turnsPlayed[p];
+        game->bonusWordsCount[p] = save.bonusWordsCount[p];
+    }
+    game->scoredWordCount = save.scoredWordCount;
+    memcpy(game->scoredWords, save.scoredWords, sizeof(save.scoredWords));
+    memcpy(game->longestWord, save.longestWord, sizeof(save.longestWord));
+    memcpy(game->bestWord, save.bestWord, sizeof(save.bestWord));
+    game->longestWordLen = save.longestWordLen;
+    game->bestWordScore = save.bestWordScore;
+
+    // Rebase onto this run's clock: the match has been going for as long as it had when saved.
+    game->gameStartTime = game->simTime - save.gameElapsedMs;
+    game->turnStartTime = game->simTime - save.turnElapsedMs;
+    game->isPaused = true;
+
+    hasSave = true;
+    savedMoves = save.turnsPlayed[0] + save.turnsPlayed[1];
+    printf("Save: resumed a match %d moves in (%u:%02u played) from %s in %.1f us\n", savedMoves,
+           save.gameElapsedMs / 60000, save.gameElapsedMs / 1000 % 60, SAVE_PATH,
+           (SDL_GetPerformanceCounter() - start) * 1000000.0 / SDL_GetPerformanceFrequency());
+    return true;
+}
+
+void Save_Discard(void) {
+    if (!hasSave) return;
+    hasSave = false;
+    savedMoves = -1;
+    remove(SAVE_PATH);
+}
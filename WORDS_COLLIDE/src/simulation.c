@@ -0,0 +1,75 @@
+#include "../include/simulation.h"
+#include "../include/logic.h"
+#include "../include/replay.h"
+#include "../include/save.h"
+
+static Uint64 frequency, ticksPerStep;
+static Uint64 lastCounter, accumulated;
+
+void Simulation_Init(GameState *game) {
+    frequency = SDL_GetPerformanceFrequency();
+    ticksPerStep = frequency * SIM_TICK_MS / 1000;
+    lastCounter = SDL_GetPerformanceCounter();
+    accumulated = 0;
+    game->simTime = SDL_GetTicks();
+    game->simTickAt = lastCounter;
+    Simulation_SyncClocks(game);
+}
+
+static void Simulation_UpdateClocks(GameState *game) {
+    Uint32 elapsed = game->simTime - game->gameStartTime;
+    game->gameTimeLeft = elapsed >= GAME_DURATION_MS ? 0 : GAME_DURATION_MS - elapsed;
+    Uint32 turnLimit = (game->gameMode == 1) ? BLITZ_TURN_DURATION_MS : TURN_DURATION_MS;
+    Uint32 turnElapsed = game->simTime - game->turnStartTime;
+    game->turnTimeLeft = turnElapsed >= turnLimit ? 0 : turnLimit - turnElapsed;
+}
+
+void Simulation_SyncClocks(GameState *game) {
+    Simulation_UpdateClocks(game);
+    game->prevGameTimeLeft = game->gameTimeLeft;
+    game->prevTurnTimeLeft = game->turnTimeLeft;
+}
+
+static void Simulation_Tick(GameState *game, AppContext *app) {
+    game->simTime += SIM_TICK_MS;
+    game->prevGameTimeLeft = game->gameTimeLeft;
+    game->prevTurnTimeLeft = game->turnTimeLeft;
+    Simulation_UpdateClocks(game);
+    if (game->currentState != STATE_PLAYING) {
+        Replay_Finish(); // the match just ended or was left; no-ops otherwise
+        Save_Discard();
+        return;
+    }
+
+    for (int x = 0; x < GRID_COLS; x++)
+        for (int y = 0; y < GRID_ROWS; y++)
+            if (game->highlightEndTime[x][y] && (Sint32)(game->simTime - (Uint32)game->highlightEndTime[x][y]) >= 0)
+                game->highlightEndTime[x][y] = 0;
+
+    if (game->isSinglePlayer && game->currentPlayer == 1 && game->simTime - game->turnStartTime > SIM_BOT_THINK_MS)
+        Logic_BotMove(game, app);
+    Save_Autosave(game);
+}
+
+void Simulation_Advance(GameState *game, AppContext *app) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    accumulated += now - lastCounter;
+    lastCounter = now;
+    Uint64 steps = accumulated / ticksPerStep;
+    accumulated %= ticksPerStep;
+    if (steps > SIM_MAX_CATCH_UP_TICKS) {
+        // Rules only ask whether something is due, so skipped ticks lose nothing but the
+        // clock has to keep up with SDL_GetTicks for the network timebase.
+        game->simTime += (Uint32)(steps - SIM_MAX_CATCH_UP_TICKS) * SIM_TICK_MS;
+        steps = SIM_MAX_CATCH_UP_TICKS;
+    }
+    for (Uint64 i = 0; i < steps; i++)
+        Simulation_Tick(game, app);
+    game->simTickAt = now - accumulated;
+}
+
+int Simulation_MsUntilNextTick(const GameState *game) {
+    Uint64 dueAt = game->simTickAt + ticksPerStep, now = SDL_GetPerformanceCounter();
+    if (now >= dueAt) return 0;
+    return (int)((dueAt - now) * 1000 / frequency) + 1; // round up so the wait ends past the tick
+}